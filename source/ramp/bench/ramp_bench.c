@@ -0,0 +1,134 @@
+/**
+	ramp_bench.c - headless benchmark of the ramp interpolation engine
+
+	drives a set of ramp engines through simulated clock ticks, without Max,
+	and reports the cost of one tick in nanoseconds per element for each interpolation mode
+
+	build and run from source/ramp:
+        cc -O2 -o ramp_bench bench/ramp_bench.c ramp_core.c ramp_curve.c ramp_kernel.c ramp_lut.c ramp_vector.c -lm
+        ./ramp_bench [-i instances] [-n elements] [-m moving] [-t ramp time] [-g grain] [-k ticks] [-s kernel] [-l table size]
+
+        moving: number of elements retargeted at a time (default: all)
+        kernel: 0 scalar, 1 sse2, 2 avx2 (default: best supported)
+        table size: easing tables size, 0 to compute the curves (default)
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "../ramp_core.h"
+
+typedef struct _bench {
+    long        instances;  // number of simulated ramp objects
+    long        len;        // number of elements per ramp object
+    long        moving;     // number of elements retargeted at a time, 0 for all
+    long        time;       // ramp time in ms
+    long        grain;      // clock grain in ms
+    long        ticks;      // number of simulated clock ticks
+    long        kernel;     // instruction set of the easing kernels, -1 for the best one
+    long        lut;        // size of the easing tables, 0 to compute the curves
+} t_bench;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static void retarget(t_ramp_core *c, long len, long moving, long seed, double now) {
+    // what ramp_list does: new destination for the moving elements, then a first output
+    long i, j;
+    c->now = now;
+    ramp_core_setlen(c, len);
+    for (j=0;j<moving;j++) {
+        i = (seed*moving+j)%len;
+        ramp_core_set(c, i, (c->dst[i] == 0) ? 1000. : 0., TYPE_FLOAT);
+    }
+    ramp_core_jump(c);
+}
+
+static double bench_mode(t_bench *b, enum mode m, double *checksum) {
+    long i, t;
+    long elements = 0;
+    double start, stop;
+    t_ramp_core *cores = malloc(b->instances*sizeof(t_ramp_core));
+
+    for (i=0;i<b->instances;i++) {
+        if (!ramp_core_new(cores+i, b->time, m, b->grain)) {
+            fprintf(stderr, "ramp_bench: out of memory\n");
+            exit(1);
+        }
+        cores[i].lut = ramp_lut_get(b->lut);
+        retarget(cores+i, b->len, b->moving, i, 0);
+    }
+
+    start = now_ns();
+    for (t=0;t<b->ticks;t++) {
+        for (i=0;i<b->instances;i++) {
+            // what the clock callback does: update, then prepare the output when something moved
+            long state = ramp_core_update(cores+i, (t+1.)*b->grain);
+            if (state & RAMP_OUTPUT) {
+                ramp_core_jump(cores+i);
+                ramp_core_clean(cores+i);
+            }
+            if (!(state & RAMP_RUNNING))
+                retarget(cores+i, b->len, b->moving, i+t, (t+1.)*b->grain);
+            elements += cores[i].len;
+        }
+    }
+    stop = now_ns();
+
+    for (i=0;i<b->instances;i++) {
+        *checksum += cores[i].act[0];
+        ramp_core_free(cores+i);
+    }
+    free(cores);
+    return (stop-start)/elements;
+}
+
+int main(int argc, char **argv) {
+    t_bench b = { 1000, 1, 0, 1000, 20, 500, -1, 0 };
+    double checksum = 0;
+    double total = 0;
+    int i;
+
+    for (i=1;i+1<argc;i+=2) {
+        long v = atol(argv[i+1]);
+        if (strcmp(argv[i],"-i")==0) b.instances = v;
+        else if (strcmp(argv[i],"-n")==0) b.len = v;
+        else if (strcmp(argv[i],"-m")==0) b.moving = v;
+        else if (strcmp(argv[i],"-t")==0) b.time = v;
+        else if (strcmp(argv[i],"-g")==0) b.grain = v;
+        else if (strcmp(argv[i],"-k")==0) b.ticks = v;
+        else if (strcmp(argv[i],"-s")==0) b.kernel = v;
+        else if (strcmp(argv[i],"-l")==0) b.lut = v;
+        else {
+            fprintf(stderr, "usage: %s [-i instances] [-n elements] [-m moving] [-t ramp time] [-g grain] [-k ticks] [-s kernel] [-l table size]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (b.moving<=0 || b.moving>b.len)
+        b.moving = b.len;
+    if (b.instances<1 || b.len<1 || b.grain<1 || b.ticks<1) {
+        fprintf(stderr, "ramp_bench: invalid settings\n");
+        return 1;
+    }
+
+    b.kernel = ramp_kernel_select(b.kernel);
+    b.lut = ramp_lut_size(b.lut);
+    printf("ramp_bench: %ld instances x %ld elements (%ld moving), %ld ms ramps, %ld ms grain, %ld ticks, %s kernels, tables %ld\n",
+           b.instances, b.len, b.moving, b.time, b.grain, b.ticks, kernel_name[b.kernel], b.lut);
+    printf("%-20s %12s\n", "mode", "ns/elem/tick");
+    for (i=0;i<LAST;i++) {
+        double ns = bench_mode(&b, i, &checksum);
+        total += ns;
+        printf("%-20s %12.2f\n", mode_name[i], ns);
+    }
+    printf("%-20s %12.2f\n", "average", total/LAST);
+    printf("checksum %g\n", checksum);
+    return 0;
+}
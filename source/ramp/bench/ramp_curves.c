@@ -0,0 +1,233 @@
+/**
+	ramp_curves.c - headless check of the easing curves and of their parameters
+
+	compares ramp_calc() with the easing formulas written out independently, for every mode at evenly spaced progressions,
+	checks that every curve starts at 0, ends at 1 and has no jump, that the block kernels give the ramp_calc() values,
+	that ramp_calc_shape() with default parameters is ramp_calc() and follows the formulas with other ones,
+	then reports the cost in nanoseconds per element of the default and of the parametrized curves
+
+	build and run from source/ramp:
+        cc -O2 -o ramp_curves bench/ramp_curves.c ramp_core.c ramp_curve.c ramp_kernel.c ramp_lut.c ramp_vector.c -lm
+        ./ramp_curves [-n progressions]
+
+	the exit status is 1 if a value is wrong
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../ramp_core.h"
+
+#define TOLERANCE 1e-12
+#define ENDS 1e-3                           // the exponential modes start or end 2^-10 away from 0 and 1
+#define JUMP 1e-4                           // largest step allowed over 1e-9 at the ends, the circular modes move by 4.5e-5 there
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static double ref_back(double k, double s) {
+    return k*k*((s+1)*k-s);
+}
+
+static double ref_elastic(double k, double a, double p) {
+    // decaying sine starting at 0, its envelope 2^-10k is shifted to reach 0 at k=1
+    double s = (a <= 1) ? p/4 : p*asin(1/a)/(2*M_PI);
+    double env = (pow(2,-10*k)-pow(2,-10))/(1-pow(2,-10));
+    if (a < 1) a = 1;
+    return 1 + a*env*sin((k-s)*(2*M_PI)/p);
+}
+
+static double ref_bounce(double k) {
+    if (k < 1/2.75) return 7.5625*k*k;
+    if (k < 2/2.75) { k -= 1.5/2.75; return 7.5625*k*k+0.75; }
+    if (k < 2.5/2.75) { k -= 2.25/2.75; return 7.5625*k*k+0.9375; }
+    k -= 2.625/2.75;
+    return 7.5625*k*k+0.984375;
+}
+
+static double ref_calc(double k, enum mode m, double power, double overshoot, double amplitude, double period) {
+    // the textbook easing equations, in/out/inout built from the same function
+    int h = (k < 0.5);
+    switch (m) {
+        case LINEAR:            return k;
+        case QUAD_IN: case CUBIC_IN: case QUARTIC_IN: case QUINTIC_IN:
+            return pow(k,power);
+        case QUAD_OUT: case CUBIC_OUT: case QUARTIC_OUT: case QUINTIC_OUT:
+            return 1-pow(1-k,power);
+        case QUAD_INOUT: case CUBIC_INOUT: case QUARTIC_INOUT: case QUINTIC_INOUT:
+            return h ? pow(2*k,power)/2 : 1-pow(2-2*k,power)/2;
+        case SINUSOIDAL_IN:     return 1-cos(k*M_PI/2);
+        case SINUSOIDAL_OUT:    return sin(k*M_PI/2);
+        case SINUSOIDAL_INOUT:  return (1-cos(k*M_PI))/2;
+        case EXPONENTIAL_IN:    return pow(2,10*k-10);
+        case EXPONENTIAL_OUT:   return 1-pow(2,-10*k);
+        case EXPONENTIAL_INOUT:
+            return h ? pow(2,20*k-10)/2 : (2-pow(2,-20*k+10))/2;
+        case CIRCULAR_IN:       return 1-sqrt(1-k*k);
+        case CIRCULAR_OUT:      return sqrt(1-(k-1)*(k-1));
+        case CIRCULAR_INOUT:    return h ? (1-sqrt(1-4*k*k))/2 : (sqrt(1-(2*k-2)*(2*k-2))+1)/2;
+        case ELASTIC_IN:        return (k == 0) ? 0 : 1-ref_elastic(1-k,amplitude,period);
+        case ELASTIC_OUT:       return (k == 1) ? 1 : ref_elastic(k,amplitude,period);
+        case ELASTIC_INOUT:
+            if (k == 0 || k == 1 || k == 0.5) return k;
+            return h ? (1-ref_elastic(1-2*k,amplitude,period))/2 : (1+ref_elastic(2*k-1,amplitude,period))/2;
+        case BACK_IN:           return ref_back(k,overshoot);
+        case BACK_OUT:          return 1-ref_back(1-k,overshoot);
+        case BACK_INOUT:        return h ? ref_back(2*k,overshoot*1.525)/2 : 1-ref_back(2-2*k,overshoot*1.525)/2;
+        case BOUNCE_IN:         return 1-ref_bounce(1-k);
+        case BOUNCE_OUT:        return ref_bounce(k);
+        case BOUNCE_INOUT:      return h ? (1-ref_bounce(1-2*k))/2 : (1+ref_bounce(2*k-1))/2;
+        default:                return k;
+    }
+}
+
+static void ref_default(enum mode m, t_ramp_shape *sh) {
+    // the parameters of the named modes
+    sh->power = (m >= QUAD_IN && m <= QUINTIC_INOUT) ? 2+(m-QUAD_IN)/3 : 0;
+    sh->overshoot = 1.70158;                // scaled by 1.525 for BACK_INOUT
+    sh->amplitude = 1;
+    sh->period = (m == ELASTIC_INOUT) ? 0.45 : 0.3;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static long check_mode(enum mode m, long n, double *k, double *e) {
+    // every check of one mode, returns the number of failures
+    static const t_ramp_shape zero;
+    static const t_ramp_shape other[] = { {2.5, 3, 1.5, 0.5}, {1.5, 0.5, 0.5, 0.2}, {7, 1, 3, 0.8} };
+    t_ramp_shape sh;
+    double err = 0, shape = 0, block = 0, jump = 0;
+    long i, j, s, fail = 0;
+
+    ref_default(m, &sh);
+    for (i=0;i<=n;i++) {
+        double x = (double)i/n;
+        double v = ramp_calc(x, m);
+        err = fmax(err, fabs(v-ref_calc(x, m, sh.power, sh.overshoot, sh.amplitude, sh.period)));
+        shape = fmax(shape, fabs(v-ramp_calc_shape(x, m, &zero)));
+        shape = fmax(shape, fabs(v-ramp_calc_shape(x, m, &sh)));
+        k[i] = x;
+    }
+
+    //-------- the curves start at 0, end at 1 and do not jump at their ends
+    if (fabs(ramp_calc(0, m)) > ENDS || fabs(ramp_calc(1, m)-1) > ENDS) {
+        printf("%s: ends at %g %g\n", mode_name[m], ramp_calc(0, m), ramp_calc(1, m));
+        fail++;
+    }
+    jump = fmax(fabs(ramp_calc(1e-9, m)-ramp_calc(0, m)), fabs(ramp_calc(1, m)-ramp_calc(1-1e-9, m)));
+    if (m == ELASTIC_INOUT || m == BACK_INOUT || m == BOUNCE_INOUT)
+        jump = fmax(jump, fabs(ramp_calc(0.5+1e-9, m)-ramp_calc(0.5-1e-9, m)));
+    if (jump > JUMP) {
+        printf("%s: jumps by %g\n", mode_name[m], jump);
+        fail++;
+    }
+
+    //-------- the block kernels of every instruction set
+    for (j=0;j<=KERNEL_AVX2;j++) {
+        if (ramp_kernel_select(j) != j)
+            continue;
+        ramp_calc_block(m, k, e, n+1);
+        for (i=0;i<=n;i++)
+            block = fmax(block, fabs(e[i]-ramp_calc(k[i], m)));
+    }
+    ramp_kernel_select(-1);
+
+    //-------- other parameters against the formulas
+    for (s=0;s<(long)(sizeof(other)/sizeof(other[0]));s++) {
+        for (i=0;i<=n;i++) {
+            double x = (double)i/n;
+            double v = ramp_calc_shape(x, m, other+s);
+            double r;
+            sh = other[s];
+            if (m >= QUAD_IN && m <= QUINTIC_INOUT)
+                r = ref_calc(x, m, sh.power, 0, 0, 0);
+            else if (m >= ELASTIC_IN && m <= ELASTIC_INOUT)
+                r = ref_calc(x, m, 0, 0, sh.amplitude, sh.period);
+            else if (m >= BACK_IN && m <= BACK_INOUT)
+                r = ref_calc(x, m, 0, sh.overshoot, 0, 0);
+            else
+                r = ramp_calc(x, m);        // no parameter
+            shape = fmax(shape, fabs(v-r));
+        }
+        if (fabs(ramp_calc_shape(0, m, other+s)) > ENDS || fabs(ramp_calc_shape(1, m, other+s)-1) > ENDS) {
+            printf("%s: ends at %g %g with parameters %ld\n", mode_name[m], ramp_calc_shape(0, m, other+s), ramp_calc_shape(1, m, other+s), s);
+            fail++;
+        }
+    }
+
+    printf("%-20s %10.1e %10.1e %10.1e %10.1e\n", mode_name[m], err, shape, block, jump);
+    fail += (err > TOLERANCE) + (shape > TOLERANCE) + (block > TOLERANCE);
+    return fail;
+}
+
+static double time_calc(enum mode m, const t_ramp_shape *sh, long n, const double *k, double *e) {
+    // ns per element of ramp_calc() when sh is NULL, of ramp_calc_shape() otherwise
+    double start;
+    long i, r, reps = 20;
+
+    start = now_ns();
+    for (r=0;r<reps;r++) {
+        if (sh)
+            for (i=0;i<=n;i++)
+                e[i] = ramp_calc_shape(k[i], m, sh);
+        else
+            for (i=0;i<=n;i++)
+                e[i] = ramp_calc(k[i], m);
+    }
+    return (now_ns()-start)/(reps*(n+1.));
+}
+
+int main(int argc, char **argv) {
+    static const t_ramp_shape zero;
+    static const t_ramp_shape other = { 2.5, 3, 1.5, 0.5 };
+    long n = 100000, fail = 0;
+    double *k, *e, sink = 0;
+    int i;
+
+    for (i=1;i+1<argc;i+=2) {
+        long v = atol(argv[i+1]);
+        if (strcmp(argv[i],"-n")==0) n = v;
+        else {
+            fprintf(stderr, "usage: %s [-n progressions]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (n<2) {
+        fprintf(stderr, "ramp_curves: invalid settings\n");
+        return 1;
+    }
+    k = malloc((n+1)*sizeof(double));
+    e = malloc((n+1)*sizeof(double));
+    if (!k || !e) {
+        fprintf(stderr, "ramp_curves: out of memory\n");
+        return 1;
+    }
+
+    printf("ramp_curves: %ld progressions\n", n);
+    printf("%-20s %10s %10s %10s %10s\n", "mode", "formula", "shape", "kernels", "end step");
+    for (i=0;i<LAST;i++)
+        fail += check_mode(i, n, k, e);
+
+    printf("%-20s %10s %10s %10s\n", "mode", "default", "0 params", "params");
+    for (i=0;i<LAST;i++) {
+        double d = time_calc(i, NULL, n, k, e);
+        double z = time_calc(i, &zero, n, k, e);
+        double p = time_calc(i, &other, n, k, e);
+        sink += e[n/3];
+        printf("%-20s %10.2f %10.2f %10.2f\n", mode_name[i], d, z, p);
+    }
+    printf("%s (%g)\n", fail ? "failed" : "ok", sink);
+    free(k);
+    free(e);
+    return fail != 0;
+}
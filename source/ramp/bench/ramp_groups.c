@@ -0,0 +1,313 @@
+/**
+	ramp_groups.c - headless check of the groups of elements (vector modes)
+
+	drives grouped elements through their ramps tick after tick and checks, at every tick:
+        lerp: the group gives the values of the same elements moving alone (the kernels of a block of one and of four differ by a few ulps)
+        slerp: the quaternion starts on the begin as sent, stays on the unit sphere and its angle to the begin grows with the curve, the shortest way
+        oklab: the colour follows a straight line in OKLab, the grey between black and white has L = 0.5
+        spline: the point passes through the via points and moves at constant speed with a linear curve
+        ungroup: elements leaving a group in the middle of a ramp go on alone from where they are and end with it,
+        a quaternion of norm 0 and a group of the wrong size fall back to a lerp or are refused
+	then reports the cost in nanoseconds per element of a tick for each vector mode against the elements moving alone
+
+	build and run from source/ramp:
+        cc -O2 -o ramp_groups bench/ramp_groups.c ramp_core.c ramp_curve.c ramp_kernel.c ramp_lut.c ramp_vector.c -lm
+        ./ramp_groups [-t ramp time] [-g grain]
+
+	the exit status is 1 if a value is wrong
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../ramp_core.h"
+
+#define TOLERANCE 1e-9
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static void setup(t_ramp_core *c, long len, const double *from, const double *to, enum type type, long time) {
+    // jump to from, then ramp to to
+    long i;
+    c->now = 0;
+    for (i=0;i<len;i++) {
+        ramp_core_time(c, i, 0);
+        ramp_core_set(c, i, from[i], type);
+    }
+    ramp_core_jump(c);
+    for (i=0;i<len;i++) {
+        ramp_core_time(c, i, time);
+        ramp_core_set(c, i, to[i], type);
+    }
+}
+
+static void new_core(t_ramp_core *c, long len, long time, enum mode m, long grain) {
+    if (!ramp_core_new(c, time, m, grain) || !ramp_core_setlen(c, len)) {
+        fprintf(stderr, "ramp_groups: out of memory\n");
+        exit(1);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static long check_lerp(long time, long grain) {
+    // every mode: a lerp group is the same elements moving alone
+    const double from[] = { 0, 10, -3, 100 }, to[] = { 5, -10, 7, 0 };
+    long m, t, i, fail = 0;
+    double err = 0;
+
+    for (m=0;m<LAST;m++) {
+        t_ramp_core alone, group;
+        long state;
+        new_core(&alone, 4, time, m, grain);
+        new_core(&group, 4, time, m, grain);
+        ramp_core_vector(&group, 0, 4, VECTOR_LERP);
+        setup(&alone, 4, from, to, TYPE_FLOAT, time);
+        setup(&group, 4, from, to, TYPE_FLOAT, time);
+        for (t=1;;t++) {
+            ramp_core_update(&alone, t*grain);
+            state = ramp_core_update(&group, t*grain);
+            for (i=0;i<4;i++)
+                err = fmax(err, fabs(alone.act[i]-group.act[i]));
+            if (!(state & RAMP_RUNNING))
+                break;
+        }
+        for (i=0;i<4;i++)
+            fail += (group.act[i] != to[i]);
+        ramp_core_free(&alone);
+        ramp_core_free(&group);
+    }
+    fail += (err > TOLERANCE);
+    printf("%-8s %8ld %10.1e\n", "lerp", fail, err);
+    return fail;
+}
+
+static long check_slerp(long time, long grain) {
+    // 120 degrees about z, then the same rotation sent as -q: the shortest way is the same one
+    const double from[] = { 0, 0, 0, 1 };
+    const double to[2][4] = { { 0, 0, 0.8660254037844386, 0.5 }, { 0, 0, -0.8660254037844386, -0.5 } };
+    long r, t, i, fail = 0;
+    double err = 0;
+
+    for (r=0;r<2;r++) {
+        t_ramp_core c;
+        long state;
+        new_core(&c, 4, time, LINEAR, grain);
+        ramp_core_vector(&c, 0, 4, VECTOR_SLERP);
+        setup(&c, 4, from, to[r], TYPE_FLOAT, time);
+        for (t=0;;t++) {
+            double n = 0, dot = 0, k = fmin(t*grain/(double)time, 1);
+            state = ramp_core_update(&c, t*grain);
+            for (i=0;i<4;i++) {
+                n += c.act[i]*c.act[i];
+                dot += c.act[i]*from[i];
+                if (t == 0)
+                    fail += (fabs(c.act[i]-from[i]) > TOLERANCE);     // the begin is never flipped
+            }
+            // angle of the rotation: twice the angle between the quaternions
+            err = fmax(err, fabs(sqrt(n)-1));
+            err = fmax(err, fabs(2*acos(fmin(fabs(dot)/sqrt(n), 1)) - k*2*M_PI/3));
+            if (!(state & RAMP_RUNNING))
+                break;
+        }
+        for (i=0;i<4;i++)
+            fail += (c.act[i] != to[r][i]);
+        ramp_core_free(&c);
+    }
+    fail += (err > TOLERANCE);
+    printf("%-8s %8ld %10.1e\n", "slerp", fail, err);
+    return fail;
+}
+
+static double lightness(const double *rgb, double scale) {
+    // OKLab L of an sRGB colour
+    double lin[3], l, m, s;
+    long i;
+    for (i=0;i<3;i++) {
+        double v = rgb[i]/scale;
+        lin[i] = (v <= 0.04045) ? v/12.92 : pow((v+0.055)/1.055, 2.4);
+    }
+    l = cbrt(0.4122214708*lin[0] + 0.5363325363*lin[1] + 0.0514459929*lin[2]);
+    m = cbrt(0.2119034982*lin[0] + 0.6806995451*lin[1] + 0.1073969566*lin[2]);
+    s = cbrt(0.0883024619*lin[0] + 0.2817188376*lin[1] + 0.6299787005*lin[2]);
+    return 0.2104542553*l + 0.7936177850*m - 0.0040720468*s;
+}
+
+static long check_oklab(long time, long grain) {
+    // black to white as floats: L grows with the curve; red to blue as ints: ends on the destination
+    const double black[] = { 0, 0, 0 }, white[] = { 1, 1, 1 };
+    const double red[] = { 255, 0, 0 }, blue[] = { 0, 0, 255 };
+    t_ramp_core c;
+    long t, i, fail = 0, state;
+    double err = 0;
+
+    new_core(&c, 3, time, LINEAR, grain);
+    ramp_core_vector(&c, 0, 3, VECTOR_OKLAB);
+    setup(&c, 3, black, white, TYPE_FLOAT, time);
+    for (t=1;;t++) {
+        double k = fmin(t*grain/(double)time, 1);
+        state = ramp_core_update(&c, t*grain);
+        err = fmax(err, fabs(lightness(c.act, 1)-k));
+        err = fmax(err, fmax(fabs(c.act[0]-c.act[1]), fabs(c.act[1]-c.act[2])));   // a grey stays grey
+        if (!(state & RAMP_RUNNING))
+            break;
+    }
+    setup(&c, 3, red, blue, TYPE_LONG, time);
+    for (t=1;;t++) {
+        state = ramp_core_update(&c, t*grain);
+        for (i=0;i<3;i++)
+            fail += (c.act[i] < -0.5 || c.act[i] > 255.5);
+        if (!(state & RAMP_RUNNING))
+            break;
+    }
+    for (i=0;i<3;i++)
+        fail += (c.act[i] != blue[i]);
+    ramp_core_free(&c);
+    fail += (err > 1e-6);
+    printf("%-8s %8ld %10.1e\n", "oklab", fail, err);
+    return fail;
+}
+
+static long check_spline(long time, long grain) {
+    // (0,0) through (1,1) (2,0) to (3,1): the steps are equal and the via points are met
+    const double from[] = { 0, 0 }, to[] = { 3, 1 }, via[] = { 1, 1, 2, 0 };
+    t_ramp_core c;
+    double prev[2] = { 0, 0 }, step = -1, err = 0, near[2] = { 1e9, 1e9 };
+    long t, i, fail = 0, state;
+
+    new_core(&c, 2, time, LINEAR, grain);
+    ramp_core_vector(&c, 0, 2, VECTOR_SPLINE);
+    fail += !ramp_core_via(&c, 0, via, 4);
+    fail += ramp_core_via(&c, 0, via, 3);   // not a whole point
+    fail += ramp_core_via(&c, 1, via, 4);   // not the first element of the group
+    setup(&c, 2, from, to, TYPE_FLOAT, time);
+    for (t=1;;t++) {
+        double d;
+        state = ramp_core_update(&c, t*grain);
+        d = hypot(c.act[0]-prev[0], c.act[1]-prev[1]);
+        if (step < 0)
+            step = d;
+        else if ((state & RAMP_RUNNING) && t*grain%time != 0)
+            err = fmax(err, fabs(d-step)/step);
+        for (i=0;i<2;i++)
+            near[i] = fmin(near[i], hypot(c.act[0]-via[2*i], c.act[1]-via[2*i+1]));
+        prev[0] = c.act[0];
+        prev[1] = c.act[1];
+        if (!(state & RAMP_RUNNING))
+            break;
+    }
+    fail += (c.act[0] != to[0] || c.act[1] != to[1]);
+    fail += (near[0] > step || near[1] > step);
+    fail += (err > 0.05);                   // the arc length table is linear between its samples, the speed ripples within them
+    ramp_core_free(&c);
+    printf("%-8s %8ld %10.1e\n", "spline", fail, err);
+    return fail;
+}
+
+static long check_ungroup(long time, long grain) {
+    const double from[] = { 0, 0, 0, 0 }, to[] = { 1, 2, 3, 4 };
+    t_ramp_core c;
+    long t, i, fail = 0, state, end = 0;
+    double err = 0;
+
+    new_core(&c, 4, time, LINEAR, grain);
+    fail += ramp_core_vector(&c, 0, 3, VECTOR_SLERP);                  // a quaternion has 4 elements
+    fail += !ramp_core_vector(&c, 0, 4, VECTOR_SLERP);
+    setup(&c, 4, from, to, TYPE_FLOAT, time);                           // from a quaternion of norm 0: lerp
+    for (t=1;;t++) {
+        double k = fmin(t*grain/(double)time, 1);
+        if (t == 10)
+            fail += !ramp_core_vector(&c, 0, 1, VECTOR_LERP);           // dissolved in the middle of the ramp
+        state = ramp_core_update(&c, t*grain);
+        for (i=0;i<4;i++)
+            err = fmax(err, fabs(c.act[i]-to[i]*k));
+        if (!(state & RAMP_RUNNING))
+            break;
+        end = t+1;
+    }
+    fail += (end != (time+grain-1)/grain) || (c.ngroup != 0);   // ends on the grain of the group
+    for (i=0;i<4;i++)
+        fail += (c.act[i] != to[i]);
+    ramp_core_free(&c);
+    fail += (err > TOLERANCE);
+    printf("%-8s %8ld %10.1e\n", "ungroup", fail, err);
+    return fail;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static double bench(enum vector kind, long dim, long len, long time, long grain) {
+    // ns per element of a tick, kind < 0 for the elements moving alone
+    t_ramp_core c;
+    double *from = calloc(len, sizeof(double)), *to = malloc(len*sizeof(double));
+    double start, elapsed = 0;
+    long i, t, ticks = 0, r;
+
+    new_core(&c, len, time, SINUSOIDAL_INOUT, grain);
+    for (i=0;i+dim<=len&&kind>=0;i+=dim)
+        ramp_core_vector(&c, i, dim, kind);
+    for (i=0;i<len;i++)
+        from[i] = (kind == VECTOR_SLERP && i%4 == 3) ? 1 : 0.1;
+    for (r=0;r<20;r++) {
+        for (i=0;i<len;i++)
+            to[i] = (kind == VECTOR_SLERP) ? ((i%4 == 2) ? 0.8660254037844386 : (i%4 == 3) ? 0.5 : 0) : 0.2+0.6*((i*7+r)%10)/10.;
+        setup(&c, len, from, to, TYPE_FLOAT, time);
+        start = now_ns();
+        for (t=1;ramp_core_update(&c, t*grain)&RAMP_RUNNING;t++)
+            ramp_core_clean(&c);
+        elapsed += now_ns()-start;
+        ticks += t;
+        setup(&c, len, to, from, TYPE_FLOAT, 0);
+        ramp_core_clean(&c);
+    }
+    ramp_core_free(&c);
+    free(from);
+    free(to);
+    return elapsed/((double)ticks*len);
+}
+
+int main(int argc, char **argv) {
+    long time = 1000, grain = 20, fail = 0;
+    int i;
+
+    for (i=1;i+1<argc;i+=2) {
+        long v = atol(argv[i+1]);
+        if (strcmp(argv[i],"-t")==0) time = v;
+        else if (strcmp(argv[i],"-g")==0) grain = v;
+        else {
+            fprintf(stderr, "usage: %s [-t ramp time] [-g grain]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (time<2*grain || grain<1) {
+        fprintf(stderr, "ramp_groups: invalid settings\n");
+        return 1;
+    }
+
+    printf("ramp_groups: %ld ms ramps, %ld ms grain\n", time, grain);
+    printf("%-8s %8s %10s\n", "vector", "fail", "max error");
+    fail += check_lerp(time, grain);
+    fail += check_slerp(time, grain);
+    fail += check_oklab(time, grain);
+    fail += check_spline(time, grain);
+    fail += check_ungroup(time, grain);
+
+    printf("%-8s %8s %12s\n", "vector", "size", "ns/elem/tick");
+    printf("%-8s %8d %12.2f\n", "alone", 1, bench(-1, 1, 1200, time, grain));
+    printf("%-8s %8d %12.2f\n", vector_name[VECTOR_LERP], 3, bench(VECTOR_LERP, 3, 1200, time, grain));
+    printf("%-8s %8d %12.2f\n", vector_name[VECTOR_LERP], 12, bench(VECTOR_LERP, 12, 1200, time, grain));
+    printf("%-8s %8d %12.2f\n", vector_name[VECTOR_SLERP], 4, bench(VECTOR_SLERP, 4, 1200, time, grain));
+    printf("%-8s %8d %12.2f\n", vector_name[VECTOR_OKLAB], 3, bench(VECTOR_OKLAB, 3, 1200, time, grain));
+    printf("%-8s %8d %12.2f\n", vector_name[VECTOR_SPLINE], 3, bench(VECTOR_SPLINE, 3, 1200, time, grain));
+    printf("%s\n", fail ? "failed" : "ok");
+    return fail != 0;
+}
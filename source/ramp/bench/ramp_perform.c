@@ -0,0 +1,145 @@
+/**
+	ramp_perform.c - headless perform loop of the ramp~ signal engine
+
+	calls ramp_core_perform() block after block as the ramp~ perform routine does, without Max,
+	checks every sample against ramp_calc() and reports the cost in nanoseconds per sample for each interpolation mode
+
+	build and run from source/ramp:
+        cc -O2 -o ramp_perform bench/ramp_perform.c ramp_core.c ramp_curve.c ramp_kernel.c ramp_lut.c ramp_vector.c -lm
+        ./ramp_perform [-c channels] [-b block size] [-r sample rate] [-t ramp time] [-n ramps] [-s kernel]
+
+        ramps: number of successive ramps per channel, every other one is retargeted before its end
+        kernel: 0 scalar, 1 sse2, 2 avx2 (default: best supported)
+
+	the exit status is 1 if a sample differs from the reference by more than 1e-9 of the ramp amplitude
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "../ramp_core.h"
+
+#define TOLERANCE 1e-9
+
+typedef struct _perform {
+    long        chans;      // number of channels, one element each
+    long        block;      // samples per perform call
+    long        sr;         // sample rate in Hz
+    long        time;       // ramp time in ms
+    long        ramps;      // number of successive ramps per channel
+    long        kernel;     // instruction set of the easing kernels, -1 for the best one
+} t_perform;
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1e9 + ts.tv_nsec;
+}
+
+static double perform_mode(t_perform *p, enum mode m, double *maxerr) {
+    // the reference restarts from the value reached when the new destination arrives, like ramp_core_set()
+    long i, j, r, s;
+    long length = (long)ceil(p->time*p->sr/1000.);
+    double step = 1000./p->sr;
+    double ns = 0;
+    double count = 0;
+    double **outs = malloc(p->chans*sizeof(double *));
+    double *bgn = malloc(p->chans*sizeof(double));
+    double *dst = malloc(p->chans*sizeof(double));
+    double *pos = malloc(p->chans*sizeof(double));
+    t_ramp_core c;
+
+    if (!outs || !bgn || !dst || !pos || !ramp_core_new(&c, p->time, m, 1) || !ramp_core_setlen(&c, p->chans)) {
+        fprintf(stderr, "ramp_perform: out of memory\n");
+        exit(1);
+    }
+    for (i=0;i<p->chans;i++) {
+        if (!(outs[i] = malloc(p->block*sizeof(double)))) {
+            fprintf(stderr, "ramp_perform: out of memory\n");
+            exit(1);
+        }
+        dst[i] = 0;
+    }
+
+    for (r=0;r<p->ramps;r++) {
+        for (i=0;i<p->chans;i++) {
+            bgn[i] = c.act[i];
+            dst[i] = (r&1) ? -100.*(i+1) : 100.*(i+1);
+            pos[i] = 0;
+            ramp_core_set(&c, i, dst[i], TYPE_FLOAT);
+        }
+        long samples = (r&1) ? length*3/4 : length+p->block;       // interrupted ramp, or whole ramp and a block of the held destination
+        for (s=0;s<samples;s+=p->block) {
+            double start = now_ns();
+            for (i=0;i<p->chans;i++)
+                ramp_core_perform(&c, i, step, outs[i], p->block);
+            ns += now_ns()-start;
+            count += p->chans*p->block;
+
+            for (i=0;i<p->chans;i++) {
+                for (j=0;j<p->block;j++) {
+                    double k = (pos[i]+j*step)/p->time;     // same rounding as the engine, the circular modes are steep at the end
+                    double ref = (k >= 1.) ? dst[i] : bgn[i]+(dst[i]-bgn[i])*ramp_calc(k, m);
+                    double err = fabs(outs[i][j]-ref)/fabs(dst[i]-bgn[i]);
+                    if (err > *maxerr)
+                        *maxerr = err;
+                }
+                pos[i] += p->block*step;
+            }
+        }
+    }
+
+    for (i=0;i<p->chans;i++)
+        free(outs[i]);
+    free(outs);
+    free(bgn);
+    free(dst);
+    free(pos);
+    ramp_core_free(&c);
+    return ns/count;
+}
+
+int main(int argc, char **argv) {
+    t_perform p = { 16, 64, 48000, 100, 20, -1 };
+    double worst = 0;
+    double total = 0;
+    int i;
+
+    for (i=1;i+1<argc;i+=2) {
+        long v = atol(argv[i+1]);
+        if (strcmp(argv[i],"-c")==0) p.chans = v;
+        else if (strcmp(argv[i],"-b")==0) p.block = v;
+        else if (strcmp(argv[i],"-r")==0) p.sr = v;
+        else if (strcmp(argv[i],"-t")==0) p.time = v;
+        else if (strcmp(argv[i],"-n")==0) p.ramps = v;
+        else if (strcmp(argv[i],"-s")==0) p.kernel = v;
+        else {
+            fprintf(stderr, "usage: %s [-c channels] [-b block size] [-r sample rate] [-t ramp time] [-n ramps] [-s kernel]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (p.chans<1 || p.block<1 || p.sr<1 || p.time<1 || p.ramps<1) {
+        fprintf(stderr, "ramp_perform: invalid settings\n");
+        return 1;
+    }
+
+    p.kernel = ramp_kernel_select(p.kernel);
+    printf("ramp_perform: %ld channels, %ld samples blocks at %ld Hz, %ld ms ramps, %ld ramps, %s kernels\n",
+           p.chans, p.block, p.sr, p.time, p.ramps, kernel_name[p.kernel]);
+    printf("%-20s %12s %12s\n", "mode", "ns/sample", "max error");
+    for (i=0;i<LAST;i++) {
+        double err = 0;
+        double ns = perform_mode(&p, i, &err);
+        total += ns;
+        if (err > worst)
+            worst = err;
+        printf("%-20s %12.2f %12.2g\n", mode_name[i], ns, err);
+    }
+    printf("%-20s %12.2f %12.2g\n", "average", total/LAST, worst);
+    return (worst > TOLERANCE) ? 1 : 0;
+}
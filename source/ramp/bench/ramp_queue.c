@@ -0,0 +1,195 @@
+/**
+	ramp_queue.c - headless check of the segment queues of the ramp engine
+
+	plays a queue of segments (holds, null segments and curves of every kind included) on one element,
+	once, looped and in ping-pong, with ticks arriving late by a random amount,
+	and checks every output against the position in the queue computed from the time elapsed since the queue started,
+	then plays it as int values sleeping until ramp_core_next() and checks that the rounded outputs are the ones of every grain
+
+	build and run from source/ramp:
+        cc -O2 -o ramp_queue bench/ramp_queue.c ramp_core.c ramp_curve.c ramp_kernel.c ramp_lut.c ramp_vector.c -lm
+        ./ramp_queue [-g grain] [-j max lateness] [-d duration] [-r seed]
+
+	the exit status is 1 if an output is wrong
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../ramp_core.h"
+
+#define TOLERANCE 1e-9
+#define MAX_TICKS 100000
+
+static const t_ramp_segment queue[] = {
+    { 10,   100,    QUAD_IN,            TYPE_FLOAT },
+    { 10,   50,     LINEAR,             TYPE_FLOAT },   // hold
+    { -5,   230,    BOUNCE_OUT,         TYPE_FLOAT },
+    { 3,    0,      LINEAR,             TYPE_FLOAT },   // jump
+    { 7,    130,    ELASTIC_OUT,        TYPE_FLOAT },
+    { 0,    70,     EXPONENTIAL_IN,     TYPE_FLOAT },
+    { 40,   300,    CUBIC_INOUT,        TYPE_FLOAT },
+    { 12,   90,     BACK_IN,            TYPE_FLOAT },
+};
+#define NSEG (long)(sizeof(queue)/sizeof(queue[0]))
+
+static double reference(double t, double origin, enum loop loop) {
+    // value of the queue t ms after its start, each segment lasting [start, start+time[
+    long j = 0, dir = 1;
+    double from = origin;
+    while (1) {
+        const t_ramp_segment *s = queue+j;
+        double to = (dir > 0) ? s->dst : (j > 0) ? queue[j-1].dst : origin;
+        if (t < s->time) {
+            double k = t/s->time;
+            if (dir > 0)
+                return from + (to-from)*ramp_calc(k, s->mode);
+            return to + (from-to)*ramp_calc(1-k, s->mode);     // the forward curve read from its end
+        }
+        t -= s->time;
+        from = to;
+        if (dir > 0 && j+1 < NSEG)
+            j++;
+        else if (dir > 0 && loop == LOOP_ON)
+            j = 0;
+        else if (dir > 0 && loop == LOOP_PINGPONG)
+            dir = -1;
+        else if (dir < 0 && j > 0)
+            j--;
+        else if (dir < 0)
+            dir = 1;
+        else
+            return from;
+    }
+}
+
+static void play(t_ramp_core *c, double origin, enum loop loop, enum type type) {
+    // jump to origin, then play the queue from time 0
+    t_ramp_segment *seg;
+    long j;
+    ramp_core_setlen(c, 1);
+    c->now = 0;
+    ramp_core_time(c, 0, 0);
+    ramp_core_set(c, 0, origin, type);
+    ramp_core_jump(c);
+    seg = ramp_core_queue(c, 0, NSEG);
+    if (!seg) {
+        fprintf(stderr, "ramp_queue: out of memory\n");
+        exit(1);
+    }
+    for (j=0;j<NSEG;j++) {
+        seg[j] = queue[j];
+        seg[j].type = type;
+    }
+    ramp_core_loop(c, 0, loop);
+    ramp_core_play(c, 0);
+}
+
+static long check_float(enum loop loop, long grain, long jitter, long duration, double *err) {
+    // late ticks: every output is the reference at the time of the tick
+    t_ramp_core c;
+    double now = 0;
+    long t, fail = 0, state = 0;
+
+    if (!ramp_core_new(&c, 0, LINEAR, grain)) {
+        fprintf(stderr, "ramp_queue: out of memory\n");
+        exit(1);
+    }
+    play(&c, 2, loop, TYPE_FLOAT);
+    for (t=1;now<duration;t++) {
+        double d;
+        now = fmax(now, t*grain + (jitter ? rand()%(jitter+1) : 0));   // a late tick delays the next ones, time never goes back
+        state = ramp_core_update(&c, now);
+        d = fabs(c.act[0]-reference(now, 2, loop));
+        *err = fmax(*err, d);
+        fail += (d > TOLERANCE*50);
+        if (!(state & RAMP_RUNNING))
+            break;
+    }
+    if (loop == LOOP_OFF)
+        fail += (state & RAMP_RUNNING) || c.act[0] != queue[NSEG-1].dst;    // the queue ends on its last target
+    else
+        fail += !(state & RAMP_RUNNING);                                    // a loop never ends
+    ramp_core_free(&c);
+    return fail;
+}
+
+static long check_skip(enum loop loop, long grain, long duration, long *ticks, long *wakes) {
+    // int values: the grains skipped by ramp_core_next() repeat the last rounded output
+    static double ref[MAX_TICKS];
+    t_ramp_core every, skip;
+    double last;
+    long n = 0, t = 0, j, fail = 0, state;
+
+    if (!ramp_core_new(&every, 0, LINEAR, grain) || !ramp_core_new(&skip, 0, LINEAR, grain)) {
+        fprintf(stderr, "ramp_queue: out of memory\n");
+        exit(1);
+    }
+    play(&every, 2, loop, TYPE_LONG);
+    play(&skip, 2, loop, TYPE_LONG);
+    do {
+        state = ramp_core_update(&every, (n+1.)*grain);
+        ref[n++] = round(every.act[0]);
+    } while ((state & RAMP_RUNNING) && n*grain < duration && n < MAX_TICKS);
+
+    last = round(skip.act[0]);
+    while (t < n) {
+        double wait = ramp_core_next(&skip, 0, 0)-(double)t*grain;
+        long grains = (wait <= grain) ? 1 : (long)ceil(wait/grain);
+        for (j=0;j<grains-1&&t+j<n;j++)
+            fail += (ref[t+j] != last);
+        t += grains;
+        if (t > n)
+            break;
+        state = ramp_core_update(&skip, (double)t*grain);
+        last = round(skip.act[0]);
+        fail += (ref[t-1] != last);
+        (*wakes)++;
+        if (!(state & RAMP_RUNNING))
+            break;
+    }
+    if (loop == LOOP_OFF)
+        fail += (t != n);                   // the queues end at the same grain
+    *ticks += n;
+    ramp_core_free(&every);
+    ramp_core_free(&skip);
+    return fail;
+}
+
+int main(int argc, char **argv) {
+    long grain = 20, jitter = 15, duration = 10000, seed = 1, fail = 0;
+    const char *loop_name[] = { "once", "loop", "ping-pong" };
+    int i;
+
+    for (i=1;i+1<argc;i+=2) {
+        long v = atol(argv[i+1]);
+        if (strcmp(argv[i],"-g")==0) grain = v;
+        else if (strcmp(argv[i],"-j")==0) jitter = v;
+        else if (strcmp(argv[i],"-d")==0) duration = v;
+        else if (strcmp(argv[i],"-r")==0) seed = v;
+        else {
+            fprintf(stderr, "usage: %s [-g grain] [-j max lateness] [-d duration] [-r seed]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (grain<1 || jitter<0 || duration<grain) {
+        fprintf(stderr, "ramp_queue: invalid settings\n");
+        return 1;
+    }
+    srand(seed);
+
+    printf("ramp_queue: %ld segments, %ld ms grain, ticks up to %ld ms late, %ld ms\n", NSEG, grain, jitter, duration);
+    printf("%-10s %10s %8s %10s %10s %8s\n", "loop", "max error", "fail", "grains", "wakeups", "diff");
+    for (i=LOOP_OFF;i<=LOOP_PINGPONG;i++) {
+        double err = 0;
+        long f, d, ticks = 0, wakes = 0;
+        f = check_float(i, grain, jitter, duration, &err);
+        d = check_skip(i, grain, duration, &ticks, &wakes);
+        printf("%-10s %10.1e %8ld %10ld %10ld %8ld\n", loop_name[i], err, f, ticks, wakes, d);
+        fail += f+d;
+    }
+    printf("%s\n", fail ? "failed" : "ok");
+    return fail != 0;
+}
@@ -0,0 +1,114 @@
+/**
+	ramp_skip.c - headless check of the tick skipping of the int ramps
+
+	drives two ramp engines with the same int ramps: one updated every grain as the ramp object does by default,
+	the other one sleeping until ramp_core_next(), as it does with @delta or @adaptive,
+	and checks that the rounded output of the second one is the first one without its repeated values, ending at the same grain
+
+	build and run from source/ramp:
+        cc -O2 -o ramp_skip bench/ramp_skip.c ramp_core.c ramp_curve.c ramp_kernel.c ramp_lut.c ramp_vector.c -lm
+        ./ramp_skip [-g grain] [-l table size]
+
+	the exit status is 1 if a rounded output differs
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../ramp_core.h"
+
+#define MAX_TICKS 100000
+
+static void ramp_from(t_ramp_core *c, double from, double to, long time) {
+    // jump to from, then ramp to to
+    ramp_core_setlen(c, 1);
+    c->now = 0;
+    ramp_core_time(c, 0, 0);
+    ramp_core_set(c, 0, from, TYPE_LONG);
+    ramp_core_jump(c);
+    ramp_core_time(c, 0, time);
+    ramp_core_set(c, 0, to, TYPE_LONG);
+}
+
+static long ramp_one(enum mode m, double from, double to, long time, long grain, long lut, long *ticks, long *wakes) {
+    // one ramp on both engines, returns the number of rounded outputs which differ
+    static double ref[MAX_TICKS];
+    t_ramp_core every, skip;
+    double now = 0, last = round(from);
+    long n = 0, t = 0, j, fail = 0, state;
+
+    if (!ramp_core_new(&every, time, m, grain) || !ramp_core_new(&skip, time, m, grain)) {
+        fprintf(stderr, "ramp_skip: out of memory\n");
+        exit(1);
+    }
+    every.lut = skip.lut = ramp_lut_get(lut);
+    ramp_from(&every, from, to, time);
+    ramp_from(&skip, from, to, time);
+
+    //-------- the rounded output of every grain
+    do {
+        state = ramp_core_update(&every, (n+1.)*grain);
+        ref[n++] = round(every.act[0]);
+    } while ((state & RAMP_RUNNING) && n < MAX_TICKS);
+
+    //-------- the skipped grains must repeat the last output
+    do {
+        double wait = ramp_core_next(&skip, 0, 0)-now;
+        long grains = (wait <= grain) ? 1 : (long)ceil(wait/grain);
+        for (j=0;j<grains-1;j++)
+            fail += (t+j >= n || ref[t+j] != last);
+        t += grains;
+        now = (double)t*grain;
+        state = ramp_core_update(&skip, now);
+        last = round(skip.act[0]);
+        fail += (t > n || ref[t-1] != last);
+        (*wakes)++;
+    } while (state & RAMP_RUNNING);
+    fail += (t != n);                       // the ramps end at the same grain
+
+    *ticks += n;
+    ramp_core_free(&every);
+    ramp_core_free(&skip);
+    return fail;
+}
+
+int main(int argc, char **argv) {
+    double ramps[][2] = { {0,10}, {10,0}, {-3,7}, {7,-3}, {0,1000}, {-0.4,0.4}, {2.5,-2.5} };
+    long grain = 20, lut = 0, fail = 0;
+    long ticks = 0, wakes = 0;
+    int i;
+
+    for (i=1;i+1<argc;i+=2) {
+        long v = atol(argv[i+1]);
+        if (strcmp(argv[i],"-g")==0) grain = v;
+        else if (strcmp(argv[i],"-l")==0) lut = v;
+        else {
+            fprintf(stderr, "usage: %s [-g grain] [-l table size]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (grain<1) {
+        fprintf(stderr, "ramp_skip: invalid settings\n");
+        return 1;
+    }
+    lut = ramp_lut_size(lut);
+    ramp_curve_bezier("ease", 0.25, 0.1, 0.25, 1);     // user curves are inverted from their tables
+    ramp_curve_points("steps", (double[]){ 0.3, 0.3, 0.7, 0.7 }, (double[]){ 0, 0.5, 0.5, 1 }, 4);
+
+    printf("ramp_skip: %ld ms grain, tables %ld\n", grain, lut);
+    printf("%-20s %10s %10s %8s\n", "mode", "grains", "wakeups", "diff");
+    for (i=0;i<ramp_mode_count();i++) {
+        long r, time, t = 0, w = 0, f = 0;
+        for (r=0;r<(long)(sizeof(ramps)/sizeof(ramps[0]));r++)
+            for (time=37;time<20000;time*=3)
+                f += ramp_one(i, ramps[r][0], ramps[r][1], time, grain, lut, &t, &w);
+        printf("%-20s %10ld %10ld %8ld\n", ramp_mode_name(i), t, w, f);
+        ticks += t;
+        wakes += w;
+        fail += f;
+    }
+    printf("wakeups %.1f%% of the grains, %ld rounded outputs differ\n", 100.*wakes/ticks, fail);
+    return fail != 0;
+}
@@ -0,0 +1,130 @@
+/**
+	ramp_timing.c - headless check of the ramp progression under irregular clock ticks
+
+	drives a ramp engine with ticks arriving late by a random amount, as a loaded scheduler does,
+	and checks that every output follows the time elapsed since the start of the ramp and that the ramps end in time,
+	then pauses and resumes the ramps and checks that they end later by the length of the pause
+
+	build and run from source/ramp:
+        cc -O2 -o ramp_timing bench/ramp_timing.c ramp_core.c ramp_curve.c ramp_kernel.c ramp_lut.c ramp_vector.c -lm
+        ./ramp_timing [-t ramp time] [-g grain] [-j max lateness] [-n ramps] [-r seed]
+
+	the exit status is 1 if an output or an end time is wrong
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "../ramp_core.h"
+
+#define TOLERANCE 1e-9
+
+typedef struct _timing {
+    long        time;       // ramp time in ms
+    long        grain;      // clock grain in ms
+    long        jitter;     // maximum lateness of a tick in ms
+    long        ramps;      // number of ramps per mode
+    long        seed;       // random seed
+} t_timing;
+
+static double lateness(t_timing *p) {
+    // mostly small delays, sometimes a stall of several grains
+    double r = rand()/(double)RAND_MAX;
+    return (r < 0.9) ? r*p->jitter : 4.*p->jitter*r;
+}
+
+static long ramp_one(t_timing *p, t_ramp_core *c, enum mode m, double *now, double pause, double *maxerr, double *maxlate, double *ticked) {
+    // one ramp from the actual value, the ramp is paused for pause ms after half of its time, returns the number of failures
+    double bgn = c->act[0], dst = (bgn == 0) ? 1000. : 0.;
+    double start = *now, end, expected;
+    double paused = 0;
+    long fail = 0;
+
+    c->now = start;
+    ramp_core_set(c, 0, dst, TYPE_FLOAT);
+    for (;;) {
+        long state;
+        *now += p->grain+lateness(p);           // clock_delay(grain), served late
+        if (pause > 0 && paused == 0 && *now-start > p->time/2.) {
+            ramp_core_shift(c, pause);          // what ramp_resume does after a pause
+            paused = pause;
+            *now += pause;
+        }
+        state = ramp_core_update(c, *now);
+        *ticked += 1;
+        if (state & RAMP_RUNNING) {
+            double k = (*now-start-paused)/p->time;
+            double ref = bgn+(dst-bgn)*ramp_calc(k, m);
+            double err = fabs(c->act[0]-ref)/fabs(dst-bgn);
+            if (err > *maxerr)
+                *maxerr = err;
+            if (err > TOLERANCE)
+                fail++;
+            continue;
+        }
+        break;
+    }
+    end = *now;
+    expected = start+paused+p->time;
+    if (c->act[0] != dst) {
+        fprintf(stderr, "ramp_timing: %s did not reach its destination\n", mode_name[m]);
+        fail++;
+    }
+    if (end < expected) {
+        fprintf(stderr, "ramp_timing: %s ended %.3f ms early\n", mode_name[m], expected-end);
+        fail++;
+    }
+    if (end-expected > *maxlate)
+        *maxlate = end-expected;
+    return fail;
+}
+
+int main(int argc, char **argv) {
+    t_timing p = { 1000, 20, 15, 20, 1 };
+    double maxerr = 0, maxlate = 0, ticks = 0;
+    long fail = 0;
+    int i;
+
+    for (i=1;i+1<argc;i+=2) {
+        long v = atol(argv[i+1]);
+        if (strcmp(argv[i],"-t")==0) p.time = v;
+        else if (strcmp(argv[i],"-g")==0) p.grain = v;
+        else if (strcmp(argv[i],"-j")==0) p.jitter = v;
+        else if (strcmp(argv[i],"-n")==0) p.ramps = v;
+        else if (strcmp(argv[i],"-r")==0) p.seed = v;
+        else {
+            fprintf(stderr, "usage: %s [-t ramp time] [-g grain] [-j max lateness] [-n ramps] [-r seed]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (p.time<1 || p.grain<1 || p.jitter<0 || p.ramps<1) {
+        fprintf(stderr, "ramp_timing: invalid settings\n");
+        return 1;
+    }
+    srand(p.seed);
+
+    printf("ramp_timing: %ld ms ramps, %ld ms grain, ticks up to %ld ms late (stalls up to %ld ms), %ld ramps per mode\n",
+           p.time, p.grain, p.jitter, 4*p.jitter, p.ramps);
+    for (i=0;i<LAST;i++) {
+        t_ramp_core c;
+        double now = 0;
+        long r;
+        if (!ramp_core_new(&c, p.time, i, p.grain)) {
+            fprintf(stderr, "ramp_timing: out of memory\n");
+            return 1;
+        }
+        for (r=0;r<p.ramps;r++)
+            fail += ramp_one(&p, &c, i, &now, (r&1) ? 3.5*p.grain : 0, &maxerr, &maxlate, &ticks);
+        ramp_core_free(&c);
+    }
+    printf("max output error      %g\n", maxerr);
+    printf("max end lateness      %.3f ms (bounded by the lateness of the last tick, at most %ld ms)\n", maxlate, p.grain+4*p.jitter);
+    printf("ticks per ramp        %.2f (a progression counted in grains needs %.0f, each late tick stretching the ramp)\n",
+           ticks/(LAST*p.ramps), ceil(p.time/(double)p.grain));
+    if (maxlate > p.grain+4*p.jitter)
+        fail++;
+    printf("%s\n", fail ? "FAILED" : "ok");
+    return fail ? 1 : 0;
+}
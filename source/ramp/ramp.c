@@ -20,86 +20,39 @@
 #define MAXAPI_USE_MSCRT
 #endif
 
-#ifndef M_PI
-#define M_PI 3.14159265358979323846
-#endif
-
-#define MAX_OBJECT 2048
-
 #include "ext.h"			// you must include this - it contains the external object's link to available Max functions
 #include "ext_obex.h"		// this is required for all objects using the newer style for writing objects.
 
-//---------------------------------------------------------------------------------------------------------------------------------------------------------
+#include "ramp_core.h"      // Max independent interpolation engine
+#include "ramp_modes.h"     // mode names interned as symbols
 
-#define MODE_LIST          \
-    X(LINEAR)              \
-    X(QUAD_IN)             \
-    X(QUAD_OUT)            \
-    X(QUAD_INOUT)          \
-    X(CUBIC_IN)            \
-    X(CUBIC_OUT)           \
-    X(CUBIC_INOUT)         \
-    X(QUARTIC_IN)          \
-    X(QUARTIC_OUT)         \
-    X(QUARTIC_INOUT)       \
-    X(QUINTIC_IN)          \
-    X(QUINTIC_OUT)         \
-    X(QUINTIC_INOUT)       \
-    X(SINUSOIDAL_IN)       \
-    X(SINUSOIDAL_OUT)      \
-    X(SINUSOIDAL_INOUT)    \
-    X(EXPONENTIAL_IN)      \
-    X(EXPONENTIAL_OUT)     \
-    X(EXPONENTIAL_INOUT)   \
-    X(CIRCULAR_IN)         \
-    X(CIRCULAR_OUT)        \
-    X(CIRCULAR_INOUT)      \
-    X(ELASTIC_IN)          \
-    X(ELASTIC_OUT)         \
-    X(ELASTIC_INOUT)       \
-    X(BACK_IN)             \
-    X(BACK_OUT)            \
-    X(BACK_INOUT)          \
-    X(BOUNCE_IN)           \
-    X(BOUNCE_OUT)          \
-    X(BOUNCE_INOUT)
-
-enum mode {
-#define X(name) name,
-    MODE_LIST
-#undef X
-    LAST
-};
-
-char *name[] = {
-#define X(name) #name,
-    MODE_LIST
-#undef X
-};
-
-typedef struct _inter {
-    double      bgn;        // beginning of the ramp
-    double      dst;        // end of the ramp
-    double      act;        // actual value
-    long        prog;       // progression of the ramp
-    long        time;       // length of the ramp (in ms)
-    bool        mask;       // is this element masked or not
-    enum mode   mode;       // type of interpolation: linear, etc...
-    e_max_atomtypes type;   // type of data A_FLOAT or A_LONG
-} t_inter;
+#define LUT_DEFAULT_SIZE 1024
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
 
+typedef struct _ramp_shared t_ramp_shared;
+
 typedef struct _ramp {          // defines our object's internal variables for each instance in a patch
     t_object    r_ob;			// object header - ALL objects MUST begin with this...
     long        r_in;           // store inlet number
-    long        r_len;          // length of the computed list
     double      r_time;         // last clock time
-    double      r_resume;       // time to resume when pause
-    long        r_grain;        // interval beetween outputs
-    char        r_reset_time;   // reset time to 0 when a ramp is done
+    double      r_resume;       // part of the grain elapsed before a pause, -1 if not paused
+    double      r_freeze;       // time of the last pause or stop, -1 if running
     char        r_force_output; // force data output type
-    t_inter     *r_values;      // array of ramped values
+    char        r_sparse;       // output index value pairs of the changed elements instead of the whole list
+    char        r_delta;        // skip the outputs and the pairs equal to the last ones
+    char        r_shared;       // updated by the clock shared by the objects of the same grain instead of its own clock
+    t_ramp_shared *r_sched;     // shared clock the object is registered with, NULL if none
+    long        r_member;       // position of the object in the members of r_sched
+    double      r_adaptive;     // smallest float change worth an update, the clock sleeps until then (0 = every grain)
+    double      r_wake;         // time of the next update (in ms)
+    long        r_lut;          // size of the easing tables, 0 to compute the curves
+    t_atom      *r_atoms;       // output buffer, kept between outputs so the clock never allocates
+    long        r_atoms_size;   // number of atoms allocated in the output buffer
+    t_atom      *r_last;        // last output value of each element, for the delta mode
+    long        r_last_size;    // number of atoms allocated in r_last
+    long        r_last_len;     // length of the last full list output, -1 to force the next one
+    t_ramp_core r_core;         // ramped values, length, grain and reset settings
     void        *r_clock;       // set a clock for this object
     void        *r_proxy;       // inlet proxy
     void        *r_outlet1;		// outlet creation - inlets are automatic, but objects must "own" their own outlets
@@ -107,6 +60,17 @@ typedef struct _ramp {          // defines our object's internal variables for e
     void        *r_outlet3;		// outlet creation - inlets are automatic, but objects must "own" their own outlets
 } t_ramp;
 
+struct _ramp_shared {           // clock shared by the objects of the same grain, they are all updated by one pass
+    long        grain;          // interval beetween updates (in ms)
+    void        *clock;         // the shared clock
+    t_ramp      **member;       // registered objects, NULL for the ones which left during the current pass
+    long        n;              // number of entries of member
+    long        size;           // number of allocated entries
+    long        live;           // number of registered objects, the clock and the entry are freed when it falls to 0
+    bool        busy;           // a pass is in progress, the entry is then freed at its end
+    t_ramp_shared *next;        // next grain
+};
+
 void *ramp_new(t_symbol *s, long argc, t_atom *argv);
 void ramp_free(t_ramp *x);
 
@@ -114,31 +78,46 @@ void ramp_int(t_ramp *x, long n);
 void ramp_float(t_ramp *x, double f);
 void ramp_list(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
 void ramp_set(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_lane(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_lanes(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_segments(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_loop(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_vector(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_via(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_curve(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_shape(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
 void ramp_time(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
 void ramp_mode(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
 void ramp_mask(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
 void ramp_any(t_ramp *x, t_symbol *s, long argc, t_atom *argv);
 
+void ramp_start(t_ramp *x);
+void ramp_schedule(t_ramp *x, double delay);
+void ramp_unschedule(t_ramp *x);
 void ramp_stop(t_ramp *x);
 void ramp_pause(t_ramp *x);
 void ramp_resume(t_ramp *x);
 void ramp_update(t_ramp *x);
-
-double powin(double k, long p);
-double powout(double k, long p);
-double powinout(double k, long p);
-double ramp_calc(double k, enum mode m);
+void ramp_shared_tick(t_ramp_shared *sh);
 
 void ramp_assist(t_ramp *x, void *b, long m, long a, char *s);
+t_max_err ramp_setlut(t_ramp *x, void *attr, long argc, t_atom *argv);
+t_max_err ramp_setdelta(t_ramp *x, void *attr, long argc, t_atom *argv);
+t_max_err ramp_setshared(t_ramp *x, void *attr, long argc, t_atom *argv);
+t_atom *ramp_atoms(t_ramp *x, long n);
 
 
 t_class *ramp_class;		// global pointer to the object class - so max can reference the object
+t_symbol *ramp_sym_unmask;      // message name compared as a pointer
+t_symbol *ramp_vector_sym[VECTOR_COUNT];    // names of the vector modes, indexed by enum vector
+t_ramp_shared *ramp_shared_list = NULL;     // shared clocks, one per grain in use, created by the first object and freed with the last
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
 
 void ext_main(void *r) {
 
     t_class *c;
+    long i;
     c = class_new("ramp", (method)ramp_new, (method)ramp_free, sizeof(t_ramp), 0L, A_GIMME, 0); // class_new() loads our external's class into Max's memory so it can be used in a patch
 
 	class_addmethod(c, (method)ramp_int,		"int",		A_LONG,     0);     // the method for an int in the left inlet                          (inlet 0)
@@ -147,6 +126,17 @@ void ext_main(void *r) {
     class_addmethod(c, (method)ramp_time,		"time",		A_GIMME,    0);     // the method to set an int, a float or a list in the time inlet    (inlet 0)
     class_addmethod(c, (method)ramp_mode,		"mode",		A_GIMME,    0);     // the method to set an int, a float or a list in the kind inlet    (inlet 0)
     class_addmethod(c, (method)ramp_mask,		"mask",		A_GIMME,    0);     // the method to set an int, a float or a list in the kind inlet    (inlet 0)
+    class_addmethod(c, (method)ramp_lane,		"lane",		A_GIMME,    0);     // ramp one element: index value [time] [mode]                      (inlet 0)
+    class_addmethod(c, (method)ramp_lanes,		"lanes",	A_GIMME,    0);     // ramp consecutive elements: start value value...                  (inlet 0)
+    class_addmethod(c, (method)ramp_segments,	"segments",	A_GIMME,    0);     // queue of ramps of one element: index value time [mode]...        (inlet 0)
+    class_addmethod(c, (method)ramp_loop,		"loop",		A_GIMME,    0);     // after the last segment: index 0 stop, 1 loop, 2 ping-pong        (inlet 0)
+    class_addmethod(c, (method)ramp_vector,		"vector",	A_GIMME,    0);     // group elements: first size [lerp|slerp|oklab|spline]            (inlet 0)
+    class_addmethod(c, (method)ramp_via,		"via",		A_GIMME,    0);     // points of the spline of a group: first x y z...                  (inlet 0)
+    class_addmethod(c, (method)ramp_curve,		"curve",	A_GIMME,    0);     // define a mode: name bezier x1 y1 x2 y2 or name points x y...     (inlet 0)
+    class_addmethod(c, (method)ramp_shape,		"power",	A_GIMME,    0);     // exponent of the quad to quintic modes, per element               (inlet 0)
+    class_addmethod(c, (method)ramp_shape,		"overshoot",A_GIMME,    0);     // overshoot of the back modes, per element                         (inlet 0)
+    class_addmethod(c, (method)ramp_shape,		"amplitude",A_GIMME,    0);     // amplitude of the elastic modes, per element                      (inlet 0)
+    class_addmethod(c, (method)ramp_shape,		"period",	A_GIMME,    0);     // period of the elastic modes, per element                         (inlet 0)
     
     class_addmethod(c, (method)ramp_stop,		"stop",     NULL,       0);     // stop the current ramp                                            (inlet 0)
     class_addmethod(c, (method)ramp_pause,		"pause",	NULL,       0);     // pause the current ramp                                           (inlet 0)
@@ -156,12 +146,12 @@ void ext_main(void *r) {
     class_addmethod(c, (method)ramp_assist,     "assist",	A_CANT,     0);     // (optional) assistance method needs to be declared like this
     class_addmethod(c, (method)stdinletinfo,    "inletinfo",A_CANT,     0);     // (optional) get all left inlet cold
 
-    CLASS_ATTR_LONG(c, "grain", 0, t_ramp, r_grain);
+    CLASS_ATTR_LONG(c, "grain", 0, t_ramp, r_core.grain);
     CLASS_ATTR_FILTER_MIN(c, "grain", 1);
     CLASS_ATTR_ORDER(c, "grain", 0, "1");
     CLASS_ATTR_LABEL(c, "grain", 0, "Grain in Milliseconds");
 
-    CLASS_ATTR_CHAR(c, "reset_time", 0, t_ramp, r_reset_time);
+    CLASS_ATTR_CHAR(c, "reset_time", 0, t_ramp, r_core.reset_time);
     CLASS_ATTR_ORDER(c, "reset_time", 0, "2");
     CLASS_ATTR_STYLE_LABEL(c, "reset_time", 0, "onoff", "Reset time when finished");
     
@@ -170,6 +160,37 @@ void ext_main(void *r) {
     CLASS_ATTR_ENUMINDEX3(c, "force_output",0,"as input","int output","float output");
     CLASS_ATTR_LABEL(c, "force_output", 0, "Fore output style");
 
+    CLASS_ATTR_LONG(c, "lut", 0, t_ramp, r_lut);
+    CLASS_ATTR_ACCESSORS(c, "lut", NULL, ramp_setlut);
+    CLASS_ATTR_ORDER(c, "lut", 0, "4");
+    CLASS_ATTR_LABEL(c, "lut", 0, "Easing table size (0 = computed)");
+
+    CLASS_ATTR_CHAR(c, "sparse", 0, t_ramp, r_sparse);
+    CLASS_ATTR_ORDER(c, "sparse", 0, "5");
+    CLASS_ATTR_STYLE_LABEL(c, "sparse", 0, "onoff", "Output index value pairs of the changed elements");
+
+    CLASS_ATTR_CHAR(c, "delta", 0, t_ramp, r_delta);
+    CLASS_ATTR_ACCESSORS(c, "delta", NULL, ramp_setdelta);
+    CLASS_ATTR_ORDER(c, "delta", 0, "6");
+    CLASS_ATTR_STYLE_LABEL(c, "delta", 0, "onoff", "Skip outputs equal to the last ones");
+
+    CLASS_ATTR_CHAR(c, "shared", 0, t_ramp, r_shared);
+    CLASS_ATTR_ACCESSORS(c, "shared", NULL, ramp_setshared);
+    CLASS_ATTR_ORDER(c, "shared", 0, "7");
+    CLASS_ATTR_STYLE_LABEL(c, "shared", 0, "onoff", "Share one clock with the objects of the same grain");
+
+    CLASS_ATTR_DOUBLE(c, "adaptive", 0, t_ramp, r_adaptive);
+    CLASS_ATTR_FILTER_MIN(c, "adaptive", 0);
+    CLASS_ATTR_ORDER(c, "adaptive", 0, "8");
+    CLASS_ATTR_LABEL(c, "adaptive", 0, "Adaptive grain resolution (0 = every grain)");
+
+    
+    ramp_modes_init();                      // intern the mode names, they are then found by pointer
+    ramp_sym_unmask = gensym("unmask");
+    for (i=0;i<VECTOR_COUNT;i++)
+        ramp_vector_sym[i] = gensym(vector_name[i]);
+    ramp_kernel_select(-1);                 // use the best instruction set of this cpu for the easing kernels
+    ramp_lut_get(LUT_DEFAULT_SIZE);         // sample the default easing tables once for all the instances
     
 	class_register(CLASS_BOX, c);
 	ramp_class = c;
@@ -181,17 +202,14 @@ void *ramp_new(t_symbol *s, long argc, t_atom *argv) {	// n = float argument typ
     
 	t_ramp *x = (t_ramp *)object_alloc(ramp_class);     // create a new instance of this object
     
-	t_inter *buffer = malloc(MAX_OBJECT*sizeof(t_inter));
-    x->r_values = buffer;
-    
-    float val   = 0.;
     long  time  = 0.;
     long  grain = 20;
     long  mode  = LINEAR;
+    long  found;
     
     unsigned char  argorder = 0;
     
-    unsigned int i,j;
+    unsigned int i;
     for (i=0;(i<argc)&&(i<2);i++) {
         
         /* arguments:
@@ -232,13 +250,9 @@ void *ramp_new(t_symbol *s, long argc, t_atom *argv) {	// n = float argument typ
                     break;
                 }
                 
-                for (j=0;j<LAST;j++) {
-                    if (strcmp(atom_getsym(argv+i)->s_name,name[j])==0) {
-                        mode = j;
-                        break;
-                    }
-                }
-                if (mode == j) {
+                found = ramp_mode_sym_find(atom_getsym(argv+i));
+                if (found >= 0) {
+                    mode = found;
                     if (i==0) argorder = 1;
                     break;
                 }
@@ -254,21 +268,28 @@ void *ramp_new(t_symbol *s, long argc, t_atom *argv) {	// n = float argument typ
     }
 
     settings:
-	for (i=0;i<MAX_OBJECT;i++) {
-        (x->r_values+i)->bgn   = val;         // set initial value in the instance's data structure
-        (x->r_values+i)->dst   = val;         // set initial value in the instance's data structure
-        (x->r_values+i)->act   = val;         // set initial value in the instance's data structure
-        (x->r_values+i)->prog  = val;         // set initial value in the instance's data structure
-        (x->r_values+i)->time  = time;        // set initial value in the instance's data structure
-        (x->r_values+i)->mode  = mode;        // set initial value in the instance's data structure
-        (x->r_values+i)->mask  = true;           // set initial value in the instance's data structure
-        (x->r_values+i)->type  = A_LONG;      // set initial value in the instance's data structure
-        }
-    
-    x->r_len = 1;                           // set 1 by default
-    x->r_grain = grain;                     // set 20 ms grain by default
-    x->r_reset_time = 0;                    // set not active by default
+    x->r_clock = NULL;                      // created last, ramp_free runs on the early exit before it
+    x->r_sched = NULL;
+    x->r_atoms = NULL;                      // output buffer allocated with the first output
+    x->r_atoms_size = 0;
+    x->r_last = NULL;                       // last values allocated with the first delta output
+    x->r_last_size = 0;
+    x->r_last_len = -1;
+    x->r_delta = 0;                         // set not active by default
+    if (!ramp_core_new(&x->r_core, time, mode, grain)) {   // set 20 ms grain and 1 element by default
+        object_error((t_object *)x, "ramp: out of memory");
+        freeobject(x);
+        return NULL;
+    }
     x->r_force_output = 0;                  // set not active by default
+    x->r_time = 0;
+    x->r_resume = -1;                       // not paused
+    x->r_freeze = -1;                       // not stopped
+    x->r_shared = 0;                        // set not active by default
+    x->r_adaptive = 0;                      // set not active by default
+    x->r_wake = 0;
+    x->r_lut = 0;                           // set not active by default
+    x->r_sparse = 0;                        // set not active by default
     
     attr_args_process(x, argc, argv);       // process arguments
 
@@ -286,8 +307,12 @@ void *ramp_new(t_symbol *s, long argc, t_atom *argv) {	// n = float argument typ
 }
 
 void ramp_free(t_ramp *x) {
-    free(x->r_values);
-    freeobject(x->r_clock);
+    ramp_unschedule(x);
+    ramp_core_free(&x->r_core);
+    free(x->r_atoms);
+    free(x->r_last);
+    if (x->r_clock)
+        freeobject(x->r_clock);
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -327,25 +352,123 @@ void ramp_assist(t_ramp *x, void *b, long m, long a, char *s) {
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
 
+t_max_err ramp_setlut(t_ramp *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        long size = ramp_lut_size(atom_getlong(argv));
+        const t_ramp_lut *lut = ramp_lut_get(size);
+        if (size && !lut) {
+            object_error((t_object *)x, "ramp: cannot allocate easing tables of size %ld", size);
+            size = 0;
+        }
+        x->r_lut = size;
+        x->r_core.lut = lut;
+    }
+    return MAX_ERR_NONE;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+t_atom *ramp_atoms(t_ramp *x, long n) {
+    // output buffer of at least n atoms, it only grows with the list so outputs do not allocate
+    if (n > x->r_atoms_size) {
+        t_atom *tmp = realloc(x->r_atoms, n*sizeof(t_atom));
+        if (!tmp) {
+            object_error((t_object *)x, "ramp: out of memory");
+            return NULL;
+        }
+        x->r_atoms = tmp;
+        x->r_atoms_size = n;
+    }
+    return x->r_atoms;
+}
+
+static void ramp_setatom(t_ramp *x, t_atom *a, long i) {
+    // get foat or int value output depending on input and attribute settings
+    t_ramp_core *c = &x->r_core;
+    if (((c->type[i] == TYPE_LONG) &&(x->r_force_output == 0))||(x->r_force_output == 1)) atom_setlong(a,round(c->act[i]));
+    if (((c->type[i] == TYPE_FLOAT)&&(x->r_force_output == 0))||(x->r_force_output == 2)) atom_setfloat(a,c->act[i]);
+}
+
+static t_atom *ramp_last(t_ramp *x, long n) {
+    // last output values of at least n elements, the values never output are A_NOTHING so they always differ
+    if (n > x->r_last_size) {
+        long i;
+        t_atom *tmp = realloc(x->r_last, n*sizeof(t_atom));
+        if (!tmp) {
+            object_error((t_object *)x, "ramp: out of memory");
+            return NULL;
+        }
+        for (i=x->r_last_size;i<n;i++)
+            tmp[i].a_type = A_NOTHING;
+        x->r_last = tmp;
+        x->r_last_size = n;
+    }
+    return x->r_last;
+}
+
+static bool ramp_same(const t_atom *a, const t_atom *b) {
+    // same output type and value, so an int element rounded to its last value does not count as a change
+    if (a->a_type != b->a_type) return false;
+    return (a->a_type == A_LONG) ? atom_getlong(a) == atom_getlong(b) : atom_getfloat(a) == atom_getfloat(b);
+}
+
+t_max_err ramp_setdelta(t_ramp *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        long i;
+        x->r_delta = atom_getlong(argv) != 0;
+        for (i=0;i<x->r_last_size;i++)      // the last values were not kept while off
+            x->r_last[i].a_type = A_NOTHING;
+        x->r_last_len = -1;
+    }
+    return MAX_ERR_NONE;
+}
+
 void ramp_bang(t_ramp *x) {
-    unsigned int i;
-    bool noramp = true;
-    t_atom *temp = malloc(x->r_len*sizeof(t_atom));
+    long i, n;
+    t_ramp_core *c = &x->r_core;
+    bool noramp = ramp_core_jump(c);
+    t_atom *temp, *last = NULL;
     
-    for (i=0;i<x->r_len;i++) {
-        // if ramp time = 0, output result directly and bang for finish immediatly if all ramp times == 0
-        if  ((x->r_values+i)->time == 0)
-            (x->r_values+i)->act = (x->r_values+i)->dst;
-        else if  ((x->r_values+i)->act != (x->r_values+i)->dst)
-            noramp = false;
-        
-        // get foat or int value output depending on input and attribute settings
-        if ((((x->r_values+i)->type == A_LONG) &&(x->r_force_output == 0))||(x->r_force_output == 1)) atom_setlong(&temp[i],round((x->r_values+i)->act));
-        if ((((x->r_values+i)->type == A_FLOAT)&&(x->r_force_output == 0))||(x->r_force_output == 2)) atom_setfloat(&temp[i],(x->r_values+i)->act);
+    // an allocation failure skips the output only, the changes are cleaned and the end of the ramps is still reported
+    if (x->r_delta && !(last = ramp_last(x, c->len)) && c->len)
+        goto done;
+    if (x->r_sparse) {
+        // index value pairs of the elements changed since the last output, nothing if none changed
+        if (!c->ndirty)
+            goto done;
+        if (!(temp = ramp_atoms(x, 2*c->ndirty)))
+            goto done;
+        for (i=0,n=0;i<c->ndirty;i++) {
+            long j = c->dirty[i];
+            if (j >= c->len) continue;
+            ramp_setatom(x,&temp[n+1],j);
+            if (last) {
+                if (ramp_same(&temp[n+1],&last[j])) continue;
+                last[j] = temp[n+1];
+            }
+            atom_setlong(&temp[n],j);
+            n += 2;
         }
-    
-    outlet_list(x->r_outlet1, NULL, x->r_len,temp);
-    free(temp);
+        if (n) outlet_list(x->r_outlet1, NULL, n, temp);
+    }
+    else {
+        bool changed = (c->len != x->r_last_len);
+        if (!(temp = ramp_atoms(x, c->len)) && c->len)
+            goto done;
+        for (i=0;i<c->len;i++) {
+            ramp_setatom(x,&temp[i],i);
+            if (last && !changed)
+                changed = !ramp_same(&temp[i],&last[i]);
+        }
+        if (last) {
+            // the whole list is kept as the last values, the sparse mode can take over
+            if (changed) memcpy(last, temp, c->len*sizeof(t_atom));
+            x->r_last_len = c->len;
+        }
+        if (!last || changed) outlet_list(x->r_outlet1, NULL, c->len,temp);
+    }
+    done:
+    ramp_core_clean(c);
     if (noramp == true) outlet_bang(x->r_outlet2);
 }
 
@@ -355,9 +478,7 @@ void ramp_int(t_ramp *x, long n) {
         case 0:
             atom_setlong(&av,n);
             ramp_set(x,NULL,1,&av);
-            ramp_stop(x);
-            ramp_bang(x);
-            clock_delay(x->r_clock,x->r_grain);
+            ramp_start(x);
             break;
         case 1:
             atom_setlong(&av,n);
@@ -368,7 +489,7 @@ void ramp_int(t_ramp *x, long n) {
             ramp_mode(x,NULL,1,&av);
             break;
         case 3:
-            x->r_grain = (n>100) ? 100 : (n<1) ? 1 : n;
+            x->r_core.grain = (n>100) ? 100 : (n<1) ? 1 : n;
             break;
     }
 }
@@ -379,9 +500,7 @@ void ramp_float(t_ramp *x, double f) {
         case 0:
             atom_setfloat(&av,f);
             ramp_set(x,NULL,1,&av);
-            ramp_stop(x);
-            ramp_bang(x);
-            clock_delay(x->r_clock,x->r_grain);
+            ramp_start(x);
             break;
         case 1:
             atom_setlong(&av,f);
@@ -392,7 +511,7 @@ void ramp_float(t_ramp *x, double f) {
             ramp_mode(x,NULL,1,&av);
             break;
         case 3:
-            x->r_grain = (long)((f>100) ? 100 : (f<1) ? 1 : f);
+            x->r_core.grain = (long)((f>100) ? 100 : (f<1) ? 1 : f);
             break;
     }
 }
@@ -401,9 +520,7 @@ void ramp_list(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
     switch (proxy_getinlet((t_object *)x)) {
         case 0:
             ramp_set(x,NULL,argc,argv);
-            ramp_stop(x);
-            ramp_bang(x);
-            clock_delay(x->r_clock,x->r_grain);
+            ramp_start(x);
             break;
         case 1:
             ramp_time(x,NULL,argc,argv);
@@ -412,398 +529,592 @@ void ramp_list(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
             ramp_mode(x,NULL,argc,argv);
             break;
         case 3:
-            x->r_grain=(long)atom_getlong(argv);
+            x->r_core.grain=(long)atom_getlong(argv);
             break;
     }
 }
 
 void ramp_any(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
-    unsigned char i;
     t_atom av;
     switch (proxy_getinlet((t_object *)x)) {
         case 0:
-            if (strcmp(s->s_name,"unmask")==0) {
+            if (s == ramp_sym_unmask) {
                 atom_setlong(&av,1);
                 ramp_mask(x, NULL, 1, &av);
                 break;
             }
         case 2:
-            for (i=0;i<LAST;i++) {
-                if (strcmp(s->s_name,name[i])==0) {
-                    ramp_mode(x,s,argc,argv);
-                    break;
-                    }
-            }
+            if (ramp_mode_sym_find(s) >= 0)
+                ramp_mode(x,s,argc,argv);
     }
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
 
+static void ramp_now(t_ramp *x) {
+    // time of the new destinations, the ramps frozen by pause or stop go on from where they were
+    clock_getftime(&x->r_time);
+    if (x->r_freeze >= 0) {
+        ramp_core_shift(&x->r_core, x->r_time-x->r_freeze);
+        x->r_freeze = -1;
+        x->r_resume = -1;
+    }
+    x->r_core.now = x->r_time;
+}
+
 void ramp_set(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
     if (argc != 0) {
-        unsigned int i;
-        x->r_len = (argc>MAX_OBJECT) ? MAX_OBJECT : argc;
-        for (i=0;i<MAX_OBJECT;i++) {
-            switch (atom_gettype(argv+(i%argc))) {
+        long i;
+        t_ramp_core *c = &x->r_core;
+        ramp_now(x);
+        if (!ramp_core_setlen(c, argc))
+            object_error((t_object *)x, "ramp: out of memory, list truncated to %ld elements", c->len);
+        for (i=0;i<c->len;i++) {
+            switch (atom_gettype(argv+i)) {
                 case A_LONG:
+                    ramp_core_set(c, i, atom_getfloat(argv+i), TYPE_LONG);
+                    break;
                 case A_FLOAT:
-                    if ((x->r_values+i)->mask == true) {
-                        (x->r_values+i)->bgn  = (x->r_values+i)->act;               // new begin is actual value
-                        (x->r_values+i)->dst  = atom_getfloat(argv+(i%argc));     // new destination is the transmitted value
-                        (x->r_values+i)->prog = 0;                                // new destination mean new start
-                        (x->r_values+i)->type = atom_gettype(argv+(i%argc));      // new destination has a type
-                    }
-                    else if (i>=argc)
-                        (x->r_values+i)->bgn =
-                        (x->r_values+i)->act =
-                        (x->r_values+i)->dst = 0;                                 // for value above list length reset to 0
+                    ramp_core_set(c, i, atom_getfloat(argv+i), TYPE_FLOAT);
                     break;
             }
         }
     }
 }
 
+static bool ramp_index(t_ramp *x, t_atom *a, long n, bool grow, long *index) {
+    // element index of a lane message, the list grows up to index+n elements for lane and lanes only, the other messages need elements of the list
+    t_ramp_core *c = &x->r_core;
+    long i = atom_getlong(a);
+    if ((atom_gettype(a) != A_LONG && atom_gettype(a) != A_FLOAT) || i < 0 || (atom_gettype(a) == A_FLOAT && atom_getfloat(a) != i)) {
+        object_error((t_object *)x, "ramp: lane index must be a non-negative int");
+        return false;
+    }
+    if (!grow && i+n > c->len) {
+        object_error((t_object *)x, "ramp: elements %ld to %ld out of the list of %ld elements", i, i+n-1, c->len);
+        return false;
+    }
+    if (i+n > c->len && !ramp_core_setlen(c, i+n)) {
+        object_error((t_object *)x, "ramp: out of memory, list truncated to %ld elements", c->len);
+        if (i >= c->len) return false;
+    }
+    *index = i;
+    return true;
+}
+
+static void ramp_setlane(t_ramp_core *c, long i, t_atom *a) {
+    switch (atom_gettype(a)) {
+        case A_LONG:
+            ramp_core_set(c, i, atom_getfloat(a), TYPE_LONG);
+            break;
+        case A_FLOAT:
+            ramp_core_set(c, i, atom_getfloat(a), TYPE_FLOAT);
+            break;
+    }
+}
+
+void ramp_lane(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // lane index value [time] [mode], the other elements keep their ramp
+    long i, found;
+    t_ramp_core *c = &x->r_core;
+    if (argc < 2) {
+        object_error((t_object *)x, "ramp: lane needs an index and a value");
+        return;
+    }
+    if (!ramp_index(x, argv, 1, true, &i))
+        return;
+    ramp_now(x);
+    if (argc > 2 && (atom_gettype(argv+2) == A_LONG || atom_gettype(argv+2) == A_FLOAT))
+        ramp_core_time(c, i, atom_getlong(argv+2));
+    if (argc > 3) {
+        switch (atom_gettype(argv+3)) {
+            case A_LONG:
+            case A_FLOAT:
+                ramp_core_mode(c, i, atom_getlong(argv+3));
+                break;
+            case A_SYM:
+                found = ramp_mode_sym_find(atom_getsym(argv+3));
+                if (found >= 0) ramp_core_mode(c, i, found);
+                break;
+        }
+    }
+    ramp_setlane(c, i, argv+1);
+    ramp_start(x);
+}
+
+void ramp_lanes(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // lanes start value value..., ramp the consecutive elements from start
+    long i, j;
+    t_ramp_core *c = &x->r_core;
+    if (argc < 2) {
+        object_error((t_object *)x, "ramp: lanes needs a start index and values");
+        return;
+    }
+    if (!ramp_index(x, argv, argc-1, true, &i))
+        return;
+    ramp_now(x);
+    for (j=0;j<argc-1&&i+j<c->len;j++)
+        ramp_setlane(c, i+j, argv+1+j);
+    ramp_start(x);
+}
+
+void ramp_segments(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // segments index value time [mode] value time [mode]..., the element plays the segments one after the other from its actual value
+    // a segment without mode uses the mode of the element, segments index alone lets the element finish its current segment
+    long i, j, n = 0;
+    t_ramp_core *c = &x->r_core;
+    t_ramp_segment *seg;
+
+    if (argc < 1) {
+        object_error((t_object *)x, "ramp: segments needs an index");
+        return;
+    }
+    for (j=1;j<argc;n++) {
+        if (j+1 >= argc || atom_gettype(argv+j) == A_SYM || atom_gettype(argv+j+1) == A_SYM) {
+            object_error((t_object *)x, "ramp: segments needs value time [mode] triplets");
+            return;
+        }
+        j += 2;
+        if (j < argc && atom_gettype(argv+j) == A_SYM) {
+            if (ramp_mode_sym_find(atom_getsym(argv+j)) < 0) {
+                object_error((t_object *)x, "ramp: unknown mode %s", atom_getsym(argv+j)->s_name);
+                return;
+            }
+            j++;
+        }
+    }
+    if (!ramp_index(x, argv, 1, false, &i))
+        return;
+    seg = ramp_core_queue(c, i, n);
+    if (n > 0 && !seg) {
+        object_error((t_object *)x, "ramp: out of memory");
+        return;
+    }
+    for (j=1,n=0;j<argc;n++) {
+        seg[n].dst = atom_getfloat(argv+j);
+        seg[n].type = (atom_gettype(argv+j) == A_LONG) ? TYPE_LONG : TYPE_FLOAT;
+        seg[n].time = (atom_getlong(argv+j+1) > 0) ? atom_getlong(argv+j+1) : 0;
+        seg[n].mode = c->mode[i];
+        j += 2;
+        if (j < argc && atom_gettype(argv+j) == A_SYM)
+            seg[n].mode = ramp_mode_sym_find(atom_getsym(argv+j++));
+    }
+    ramp_now(x);
+    ramp_core_play(c, i);
+    ramp_start(x);
+}
+
+void ramp_loop(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // loop index 0|1|2: the queue of the element stops after its last segment, starts again from the first one or goes back and forth
+    long i;
+    if (argc < 2) {
+        object_error((t_object *)x, "ramp: loop needs an index and 0, 1 or 2");
+        return;
+    }
+    if (!ramp_index(x, argv, 1, false, &i))
+        return;
+    ramp_core_loop(&x->r_core, i, atom_getlong(argv+1));
+}
+
+void ramp_vector(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // vector first size [kind], the size elements from first share one progression, a size below 2 ungroups them
+    long i, dim = 0, kind = VECTOR_LERP;
+    t_ramp_core *c = &x->r_core;
+
+    if (argc < 1) {
+        object_error((t_object *)x, "ramp: vector needs a first element and a size");
+        return;
+    }
+    if (argc > 1)
+        dim = atom_getlong(argv+1);
+    if (argc > 2) {
+        for (kind=0;kind<VECTOR_COUNT&&ramp_vector_sym[kind]!=atom_getsym(argv+2);kind++);
+        if (kind == VECTOR_COUNT) {
+            object_error((t_object *)x, "ramp: unknown vector mode %s", atom_getsym(argv+2)->s_name);
+            return;
+        }
+    }
+    if (!ramp_index(x, argv, (dim > 1) ? dim : 1, false, &i))
+        return;
+    ramp_now(x);
+    if (!ramp_core_vector(c, i, dim, kind))
+        object_error((t_object *)x, "ramp: %s needs %s", vector_name[kind], (kind == VECTOR_SLERP) ? "4 elements" : (kind == VECTOR_OKLAB) ? "3 elements" : "memory");
+    else if (c->nactive)
+        ramp_schedule(x, c->grain);         // grouped or ungrouped, the moving elements go on
+}
+
+void ramp_via(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // via first x y z x y z..., the next ramps of the spline group from first go through these points
+    long i, j;
+    double *v;
+    t_ramp_core *c = &x->r_core;
+
+    if (argc < 1 || !ramp_index(x, argv, 1, false, &i))
+        return;
+    v = (argc > 1) ? malloc((argc-1)*sizeof(double)) : NULL;
+    if (argc > 1 && !v) {
+        object_error((t_object *)x, "ramp: out of memory");
+        return;
+    }
+    for (j=1;j<argc;j++)
+        v[j-1] = atom_getfloat(argv+j);
+    if (!ramp_core_via(c, i, v, argc-1))
+        object_error((t_object *)x, "ramp: via needs the first element of a group and whole points");
+    free(v);
+}
+
+void ramp_curve(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // the new curve is a mode of every ramp object, used by its name like the built-in ones
+    ramp_curve_message((t_object *)x, "ramp", argc, argv);
+}
+
+void ramp_shape(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
+    // a list of curve parameters repeated over the elements like the times, 0 is the default of the mode
+    long i;
+    t_ramp_core *c = &x->r_core;
+    enum param p = ramp_param_sym_find(s);
+    if (p < PARAM_POWER)
+        return;
+    if (argc != 0) {
+        double *pattern = ramp_core_pattern(c, p, argc);
+        if (!pattern) {
+            object_error((t_object *)x, "ramp: out of memory");
+            return;
+        }
+        for (i=0;i<argc;i++) {
+            switch (atom_gettype(argv+i)) {
+                case A_LONG:
+                case A_FLOAT:
+                    pattern[i] = atom_getfloat(argv+i);
+                    break;
+                default:
+                    pattern[i] = PATTERN_SKIP;
+                    break;
+            }
+        }
+        ramp_core_apply(c, p);
+    }
+    else {
+        t_atom *temp = ramp_atoms(x, c->len);
+        if (!temp) return;
+        for (i=0;i<c->len;i++) {
+            atom_setfloat(&temp[i],ramp_core_getshape(c,i,p));
+        }
+        outlet_anything(x->r_outlet3, s, c->len, temp);
+    }
+}
+
 void ramp_time(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
-    unsigned int i;
+    long i;
+    t_ramp_core *c = &x->r_core;
     if (argc != 0) {
-        for (i=0;i<MAX_OBJECT;i++) {
-            switch (atom_gettype(argv+(i%argc))) {
+        double *pattern = ramp_core_pattern(c, PARAM_TIME, argc);
+        if (!pattern) {
+            object_error((t_object *)x, "ramp: out of memory");
+            return;
+        }
+        for (i=0;i<argc;i++) {
+            switch (atom_gettype(argv+i)) {
                 case A_LONG:
                 case A_FLOAT:
-                    if ((x->r_values+i)->mask == true)
-                        (x->r_values+i)->time = atom_getlong(argv+(i%argc));
+                    pattern[i] = atom_getlong(argv+i);
+                    break;
+                default:
+                    pattern[i] = PATTERN_SKIP;
                     break;
             }
         }
+        ramp_core_apply(c, PARAM_TIME);
     }
     else {
-		t_atom *temp = malloc(x->r_len*sizeof(t_atom));
-        for (i=0;i<x->r_len;i++) {
-                atom_setlong(&temp[i],(x->r_values+i)->time);
+        t_atom *temp = ramp_atoms(x, c->len);
+        if (!temp) return;
+        for (i=0;i<c->len;i++) {
+                atom_setlong(&temp[i],c->time[i]);
             }
-        outlet_anything(x->r_outlet3, gensym("time"), x->r_len, temp);
-		free(temp);
+        outlet_anything(x->r_outlet3, gensym("time"), c->len, temp);
     }
 }
 
 void ramp_mode(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
-    unsigned int i,j;
+    long i, found;
+    t_ramp_core *c = &x->r_core;
+    double *pattern;
     
+    found = s ? ramp_mode_sym_find(s) : -1;     // the message selector can be a mode name
     if (argc == 0) {
-        if (s) {
-            for (i=0;i<LAST;i++) {
-                if (strcmp(s->s_name,name[i])==0) {
-                    for (j=0;j<MAX_OBJECT;j++) {
-                        if ((x->r_values+i)->mask == true)
-                            x->r_values[j].mode=i;
-                    }
-                    return;
-                }
+        if (found >= 0) {
+            pattern = ramp_core_pattern(c, PARAM_MODE, 1);
+            if (pattern) {
+                pattern[0] = found;
+                ramp_core_apply(c, PARAM_MODE);
             }
-            if (strcmp(s->s_name,"mode")==0) {
-				t_atom *temp = malloc(x->r_len*sizeof(t_atom));
-				for (i = 0; i<x->r_len; i++) {
-                    atom_setlong(&temp[i],(x->r_values+i)->mode);
-                }
-                outlet_anything(x->r_outlet3, gensym("mode"), x->r_len, temp);
-				free(temp);
-				return;
-            }
-            else {
-                post("ramp: do not understant %s",s->s_name);
-                return;
+            return;
+        }
+        if (s == ramp_param_sym[PARAM_MODE]) {
+            t_atom *temp = ramp_atoms(x, c->len);
+            if (!temp) return;
+            for (i = 0; i<c->len; i++) {
+                atom_setlong(&temp[i],c->mode[i]);
             }
+            outlet_anything(x->r_outlet3, gensym("mode"), c->len, temp);
+            return;
         }
+        if (s) post("ramp: do not understant %s",s->s_name);
     }
     else {
-        unsigned char mode;
-        if (s) {
-            for (i=0;i<LAST;i++) {
-                if (strcmp(s->s_name,name[i])==0) {
-                    mode=i;
-                    break;
-                }
-            }
+        long n = argc+(found>=0 ? 1 : 0);
+        pattern = ramp_core_pattern(c, PARAM_MODE, n);
+        if (!pattern) {
+            object_error((t_object *)x, "ramp: out of memory");
+            return;
         }
-        for (i=0;i<MAX_OBJECT;i++) {
-            if ((s)&&(i%(argc+1) == 0)) {
-                if ((x->r_values+i)->mask == true)
-                    (x->r_values+i)->mode=mode;
-            }
-            else {
-                switch (atom_gettype(argv+(i%(argc+(s?1:0))-(s?1:0)))) {
-                    case A_LONG:
-                    case A_FLOAT:
-                        if ((x->r_values+i)->mask == true)
-                            (x->r_values+i)->mode = atom_getlong(argv+(i%(argc+(s?1:0))-(s?1:0)));
-                        break;
-                    case A_SYM:
-                        for (j=0;j<LAST;j++) {
-                            if (strcmp(atom_getsym(argv+(i%(argc+(s?1:0))-(s?1:0)))->s_name,name[j])==0) {
-                                if ((x->r_values+i)->mask == true)
-                                    (x->r_values+i)->mode = j;
-                                break;
-                            }
-                        }
-                        break;
-                }
+        if (found >= 0)
+            *pattern++ = found;
+        for (i=0;i<argc;i++) {
+            switch (atom_gettype(argv+i)) {
+                case A_LONG:
+                case A_FLOAT:
+                    pattern[i] = atom_getlong(argv+i);
+                    break;
+                case A_SYM:
+                    found = ramp_mode_sym_find(atom_getsym(argv+i));
+                    pattern[i] = (found >= 0) ? found : PATTERN_SKIP;
+                    break;
+                default:
+                    pattern[i] = PATTERN_SKIP;
+                    break;
             }
         }
+        ramp_core_apply(c, PARAM_MODE);
     }
 }
 
 void ramp_mask(t_ramp *x, t_symbol *s, long argc, t_atom *argv) {
-    unsigned int i;
+    long i;
+    t_ramp_core *c = &x->r_core;
     if (argc != 0) {
-        for (i=0;i<MAX_OBJECT;i++) {
-            switch (atom_gettype(argv+(i%argc))) {
+        double *pattern = ramp_core_pattern(c, PARAM_MASK, argc);
+        if (!pattern) {
+            object_error((t_object *)x, "ramp: out of memory");
+            return;
+        }
+        for (i=0;i<argc;i++) {
+            switch (atom_gettype(argv+i)) {
                 case A_LONG:
                 case A_FLOAT:
-                    (x->r_values+i)->mask = atom_getlong(argv+(i%argc)) == 0 ? false : true;
+                    pattern[i] = atom_getlong(argv+i) != 0;
+                    break;
+                default:
+                    pattern[i] = PATTERN_SKIP;
                     break;
             }
         }
+        ramp_core_apply(c, PARAM_MASK);
     }
     else {
-        t_atom *temp = malloc(x->r_len*sizeof(t_atom));
-        for (i=0;i<x->r_len;i++) {
-            atom_setlong(&temp[i],(x->r_values+i)->mask);
+        t_atom *temp = ramp_atoms(x, c->len);
+        if (!temp) return;
+        for (i=0;i<c->len;i++) {
+            atom_setlong(&temp[i],ramp_core_masked(c,i));
         }
-        outlet_anything(x->r_outlet3, gensym("time"), x->r_len, temp);
-        free(temp);
+        outlet_anything(x->r_outlet3, gensym("mask"), c->len, temp);
     }
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
 
-void ramp_update(t_ramp *x) {
-    unsigned int i;
-    bool output = false;
-    bool finished = true;
-    
-    clock_getftime(&x->r_time);
+static double ramp_delay(t_ramp *x) {
+    // one grain, or as many grains as the output can wait, so the updates stay in phase with the grain
+    // with @delta the int elements skip the grains which would output the same rounded values, with @adaptive the float ones too
+    double grain = x->r_core.grain;
+    double wait;
+    if (x->r_adaptive <= 0 && !x->r_delta)
+        return grain;
+    wait = ramp_core_next(&x->r_core, x->r_adaptive, x->r_force_output) - x->r_time;
+    return (wait <= grain) ? grain : grain*ceil(wait/grain);
+}
+
+static long ramp_tick(t_ramp *x, double now) {
+    // one update at time now, the next one is scheduled before the output as the output can restart the ramp
+    long state;
     
-    for (i=0;i<x->r_len;i++) {
-        double val   = (x->r_values+i)->bgn;
-        double dst   = (x->r_values+i)->dst;
-        
-        if ((dst != (x->r_values+i)->act) && (dst != val)) {
-            output = true;
-            if (((x->r_values+i)->time - (x->r_values+i)->prog) > x->r_grain ) {
-                finished = false;
-                (x->r_values+i)->prog += x->r_grain;
-                val += (dst-val)*ramp_calc((x->r_values+i)->prog/(double)(x->r_values+i)->time,(x->r_values+i)->mode);
-            }
-            else {
-                (x->r_values+i)->prog = (x->r_values+i)->time;
-                val = dst;
-            }
-            (x->r_values+i)->act=val;
-        }
-        if ((x->r_values+i)->prog == (x->r_values+i)->time) {
-            if (x->r_reset_time==1)
-                (x->r_values+i)->prog = (x->r_values+i)->time = 0;
-        }
-    }
+    x->r_time = now;
+    state = ramp_core_update(&x->r_core, now);
 
     //-------- output the result
-    if (finished == false) clock_delay(x->r_clock,x->r_grain);
-    else if (output == true) {
-        outlet_bang(x->r_outlet2);
-        clock_unset(x->r_clock);
+    if (state & RAMP_RUNNING) ramp_schedule(x, ramp_delay(x));
+    else {
+        ramp_unschedule(x);
+        if (state & RAMP_OUTPUT) outlet_bang(x->r_outlet2);
         }
-    if (output == true) ramp_bang(x);
+    if (state & RAMP_OUTPUT) ramp_bang(x);
+    return state;
 }
 
-void ramp_stop(t_ramp *x) {
-    //stop the ramp and set actual result to be the actual value
-    x->r_resume = 0;
-    clock_unset(x->r_clock);
-}
-
-void ramp_pause(t_ramp *x) {
-    //pause the clock and store the time ellapsed since the last clock, keep the rest for resume
-    double t;
-    clock_unset(x->r_clock);
-    clock_getftime(&t);
-    x->r_resume = t-x->r_time;
+void ramp_update(t_ramp *x) {
+    double now;
+    clock_getftime(&now);
+    ramp_tick(x, now);
 }
 
-void ramp_resume(t_ramp *x) {
-    //resume the clock from last pause
-    if (x->r_resume!=0) {
-        x->r_resume = 0;
-        clock_fdelay(x->r_clock,x->r_grain);
-        }
+void ramp_start(t_ramp *x) {
+    //output the new destinations, the next update comes one grain after the message (or with the next shared update)
+    ramp_bang(x);
+    ramp_schedule(x, x->r_core.grain);
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
 
-double powin(double k, long p) {
-    return pow(k,p);
+static t_ramp_shared *ramp_shared_get(long grain) {
+    t_ramp_shared *sh;
+    for (sh=ramp_shared_list;sh;sh=sh->next)
+        if (sh->grain == grain)
+            return sh;
+    if (!(sh = calloc(1, sizeof(t_ramp_shared))))
+        return NULL;
+    sh->grain = grain;
+    sh->clock = clock_new((t_object *)sh, (method)ramp_shared_tick);
+    sh->next = ramp_shared_list;
+    ramp_shared_list = sh;
+    return sh;
 }
 
-double powout(double k, long p) {
-    return 1-pow(1-k,p);
+static void ramp_shared_free(t_ramp_shared *sh) {
+    t_ramp_shared **p;
+    for (p=&ramp_shared_list;*p!=sh;p=&(*p)->next)
+        ;
+    *p = sh->next;
+    freeobject((t_object *)sh->clock);
+    free(sh->member);
+    free(sh);
 }
 
-double powinout(double k, long p) {
-    k *= 2;
-    if (k<1)
-        return 0.5*pow(k,p);
-    return 1-0.5*fabs(pow(2-k,p));
+static void ramp_shared_leave(t_ramp *x) {
+    // the entry is emptied, the members are packed at the end of the next pass so a pass in progress is not disturbed
+    t_ramp_shared *sh = x->r_sched;
+    if (sh) {
+        sh->member[x->r_member] = NULL;
+        x->r_sched = NULL;
+        x->r_wake = 0;
+        if (--sh->live == 0 && !sh->busy)
+            ramp_shared_free(sh);
+    }
 }
 
-double ramp_calc(double k, enum mode m) {
-    
-    double a, p, s;
+static bool ramp_shared_join(t_ramp *x) {
+    // register with the shared clock of the grain of the object, the clock is started by its first member
+    t_ramp_shared *sh;
+    if (x->r_sched) {
+        if (x->r_sched->grain == x->r_core.grain)
+            return true;
+        ramp_shared_leave(x);           // the grain changed
+    }
+    if (!(sh = ramp_shared_get(x->r_core.grain)))
+        return false;
+    if (sh->n == sh->size) {
+        long size = (sh->size < MIN_OBJECT) ? MIN_OBJECT : 2*sh->size;
+        t_ramp **tmp = realloc(sh->member, size*sizeof(t_ramp *));
+        if (!tmp)
+            return false;
+        sh->member = tmp;
+        sh->size = size;
+    }
+    if (sh->n == 0)
+        clock_delay(sh->clock, sh->grain);
+    x->r_sched = sh;
+    x->r_member = sh->n;
+    sh->member[sh->n++] = x;
+    sh->live++;
+    return true;
+}
+
+void ramp_shared_tick(t_ramp_shared *sh) {
+    // every member is updated at the same time, the idle ones leave, the adaptive ones wait for their time
+    long i, j, n = sh->n;
+    double now;
     
-    switch (m) {
-        case QUAD_IN:
-            return powin(k,2);
-            
-        case QUAD_OUT:
-            return powout(k,2);
-            
-        case QUAD_INOUT:
-            return powinout(k,2);
-            
-        case CUBIC_IN:
-            return powin(k,3);
-            
-        case CUBIC_OUT:
-            return powout(k,3);
-            
-        case CUBIC_INOUT:
-            return powinout(k,3);
-            
-        case QUARTIC_IN:
-            return powin(k,4);
-            
-        case QUARTIC_OUT:
-            return powout(k,4);
-            
-        case QUARTIC_INOUT:
-            return powinout(k,4);
-            
-        case QUINTIC_IN:
-            return powin(k,5);
-            
-        case QUINTIC_OUT:
-            return powout(k,5);
-            
-        case QUINTIC_INOUT:
-            return powinout(k,5);
-
-        case SINUSOIDAL_IN:
-            return 1-cos(k*(M_PI/2));
-            
-        case SINUSOIDAL_OUT:
-            return sin(k*(M_PI/2));
-            
-        case SINUSOIDAL_INOUT:
-            return -0.5*(cos(M_PI*k)-1);
-            
-        case EXPONENTIAL_IN:
-            return pow(2,10*(k-1));
-            
-        case EXPONENTIAL_OUT:
-            return (1-pow(2,-10*k));
-            
-        case EXPONENTIAL_INOUT:
-            k *= 2.;
-            if (k<1)
-                return 0.5*pow(2,10*(k-1));
-            k--;
-            return 0.5*(2-pow(2,-10*k));
-            
-        case CIRCULAR_IN:
-            return -(sqrt(1-k*k)-1);
-            
-        case CIRCULAR_OUT:
-            k--;
-            return sqrt(1-k*k);
-            
-        case CIRCULAR_INOUT:
-            k *= 2;
-            if (k<1)
-                return -0.5*(sqrt(1-k*k)-1);
-            k -= 2;
-            return 0.5*(sqrt(1-k*k)+1);
-
-        case ELASTIC_IN:
-            if (k == 0 || k == 1)
-                return k;
-            k -= 1;
-            a = 1;
-            p = 0.3*1.5;
-            s = p*asin(1/a) / (2*M_PI);
-            return -a*pow(2,10*k)*sin((k-s)*(2*M_PI)/p);
-            
-        case ELASTIC_OUT:       //BUG
-            if (k == 0 || k == 1)
-                return k;
-            a = 1;
-            p = 0.3;
-            s = p*asin(1/a) / (2*M_PI);
-            return (a*pow(2,-10*k)*sin((k-s)*(2*M_PI)/p)+1);
-
-            
-        case ELASTIC_INOUT:     //BUG
-            if (k == 0 || k == 1)
-                return k;
-            k = k*2 - 1;
-            a = 1;
-            p = 0.3*1.5;
-            s = p*asin(1/a) / (2*M_PI);
-            if ((k + 1) < 1)
-                return -0.5*a*pow(2,10*k)*sin((k-s)*(2*M_PI)/p);
-            return a*pow(2,-10*k)*sin((k-s)*(2*M_PI)/p)*0.5+1;
-            
-        case BACK_IN:
-            s = 1.70158;
-            return k*k*((s+1)*k-s);
-            
-        case BACK_OUT:
-            k--;
-            s = 1.70158;
-            return k*k*((s+1)*k+s)+1;
-            
-        case BACK_INOUT:
-            k *= 2;
-            s = 1.70158;
-            s *= 1.525;
-            if (k < 1)
-                return 0.5*k*k*((s+1)*k-s);
-            k -= 2;
-            return 0.5*k*k*((s+1)*k+s)+1;
-
-        case BOUNCE_IN:
-            return 1-ramp_calc(1-k,BOUNCE_OUT);
-            
-        case BOUNCE_OUT:
-            if (k < (1/2.75))
-                return 7.5625*k*k;
-            if (k < (2/2.75)) {
-                k -= 1.5/2.75;
-                return 7.5625*k*k+0.75;
-            }
-            if (k < (2.5/2.75)) {
-                k -= (2.25/2.75);
-                return 7.5625*k*k+0.9375;
-            }
-            k -= (2.625/2.75);
-            return 7.5625*k*k+0.984375;
-            
-        case BOUNCE_INOUT:
-            if (k < 0.5) {
-                return ramp_calc(k*2,BOUNCE_IN)*0.5;
+    clock_getftime(&now);
+    sh->busy = true;
+    for (i=0;i<n;i++) {
+        if (sh->member[i] && sh->member[i]->r_wake <= now+sh->grain*0.5)
+            ramp_tick(sh->member[i], now);
+    }
+    sh->busy = false;
+    for (i=0,j=0;i<sh->n;i++) {
+        if (sh->member[i]) {
+            sh->member[j] = sh->member[i];
+            sh->member[j]->r_member = j;
+            j++;
+        }
+    }
+    sh->n = j;
+    if (sh->n)
+        clock_delay(sh->clock, sh->grain);
+    else
+        ramp_shared_free(sh);               // the last members left during the pass
+}
+
+void ramp_schedule(t_ramp *x, double delay) {
+    // next update after delay, by the shared clock of the grain or by the own clock of the object
+    x->r_wake = x->r_time+delay;
+    if (x->r_shared && ramp_shared_join(x))
+        return;
+    ramp_shared_leave(x);
+    clock_fdelay(x->r_clock,delay);
+}
+
+void ramp_unschedule(t_ramp *x) {
+    ramp_shared_leave(x);
+    if (x->r_clock)
+        clock_unset(x->r_clock);
+}
+
+t_max_err ramp_setshared(t_ramp *x, void *attr, long argc, t_atom *argv) {
+    if (argc && argv) {
+        char shared = atom_getlong(argv) != 0;
+        if (shared != x->r_shared) {
+            x->r_shared = shared;
+            if (x->r_sched || (x->r_core.nactive && x->r_freeze < 0)) {     // running: move to the other clock
+                clock_unset(x->r_clock);
+                ramp_schedule(x, x->r_core.grain);
             }
-            return ramp_calc(k*2-1,BOUNCE_OUT)*0.5+0.5;
-            break;
-            
-        case LINEAR:
-        default:
-            return k;
+        }
     }
-}
\ No newline at end of file
+    return MAX_ERR_NONE;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_stop(t_ramp *x) {
+    //stop the ramp and set actual result to be the actual value, a new destination restarts the other elements from there
+    ramp_unschedule(x);
+    if (x->r_freeze < 0)
+        clock_getftime(&x->r_freeze);
+    x->r_resume = -1;
+}
+
+void ramp_pause(t_ramp *x) {
+    //pause the clock and store the time ellapsed since the last clock, keep the rest for resume
+    if (x->r_freeze >= 0)
+        return;
+    ramp_unschedule(x);
+    clock_getftime(&x->r_freeze);
+    x->r_resume = x->r_freeze-x->r_time;
+}
+
+void ramp_resume(t_ramp *x) {
+    //resume the clock from last pause, the ramps are delayed by the pause and the next clock comes after the rest of the grain
+    double t;
+    if (x->r_resume >= 0) {
+        clock_getftime(&t);
+        ramp_core_shift(&x->r_core, t-x->r_freeze);
+        x->r_time += t-x->r_freeze;
+        if (x->r_shared)
+            ramp_schedule(x, x->r_core.grain);  // in phase with the shared clock rather than after the rest of the grain
+        else
+            clock_fdelay(x->r_clock,(x->r_resume < x->r_core.grain) ? x->r_core.grain-x->r_resume : 0);
+        x->r_resume = -1;
+        x->r_freeze = -1;
+        }
+}
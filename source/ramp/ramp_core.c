@@ -0,0 +1,1181 @@
+/**
+	ramp_core.c - Max independent interpolation engine of the ramp object
+
+	the interpolation equation comes from those website:
+        http://sole.github.io/tween.js/examples/03_graphs.html
+        https://github.com/CreateJS/TweenJS/blob/master/src/tweenjs/Ease.js
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ramp_core.h"
+
+const char *mode_name[] = {
+#define X(name) #name,
+    MODE_LIST
+#undef X
+};
+
+const char *param_name[] = { "time", "mode", "mask", "power", "overshoot", "amplitude", "period" };
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static void ramp_core_refresh(t_ramp_core *c, long from, long to);
+static void ramp_core_activate(t_ramp_core *c, long i);
+static void ramp_core_deactivate(t_ramp_core *c, long i);
+static void ramp_core_advance(t_ramp_core *c, long i);
+static bool ramp_core_arrive(t_ramp_core *c, long i);
+static void ramp_core_regroup(t_ramp_core *c, t_ramp_group *g);
+
+bool ramp_core_new(t_ramp_core *c, long time, enum mode mode, long grain) {
+    enum param p;
+
+    memset(c, 0, sizeof(t_ramp_core));
+    c->deftime = time;
+    c->defmode = mode;
+    c->grain = grain;
+    c->reset_time = 0;                      // set not active by default
+    c->lut = NULL;                          // compute the curves by default
+
+    for (p=0;p<PARAM_COUNT;p++) {
+        if (!ramp_core_pattern(c, p, 1)) {
+            ramp_core_free(c);
+            return false;
+        }
+        c->pattern[p].v[0] = PATTERN_SKIP;  // every element starts with the default time, mode, mask and curve parameters
+    }
+    if (!ramp_core_setlen(c, 1)) {          // set 1 by default
+        ramp_core_free(c);
+        return false;
+    }
+    return true;
+}
+
+void ramp_core_free(t_ramp_core *c) {
+    enum param p;
+    long i;
+    for (i=0;i<c->cap;i++)
+        free(c->queue[i].seg);
+    free(c->queue);
+    for (i=0;i<c->ngroup;i++)
+        ramp_vector_free(c->group+i);
+    free(c->group);
+    free(c->member);
+    free(c->bgn);
+    free(c->dst);
+    free(c->act);
+    free(c->start);
+    free(c->elapsed);
+    free(c->time);
+    free(c->mask);
+    free(c->mode);
+    free(c->type);
+    free(c->shape);
+    free(c->shaped);
+    free(c->active);
+    free(c->slot);
+    free(c->dirty);
+    free(c->dirtybit);
+    free(c->lane);
+    free(c->k);
+    for (p=0;p<PARAM_COUNT;p++)
+        free(c->pattern[p].v);
+    memset(c, 0, sizeof(t_ramp_core));
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static bool grow(void **ptr, long n, size_t size) {
+    void *tmp = realloc(*ptr, n*size);
+    if (!tmp)
+        return false;
+    *ptr = tmp;
+    return true;
+}
+
+bool ramp_core_reserve(t_ramp_core *c, long n) {
+    // make room for n elements, the capacity is doubled so a growing list is reallocated log(n) times
+    long i, cap = c->cap;
+    if (n <= cap)
+        return true;
+    if (cap < MIN_OBJECT)
+        cap = MIN_OBJECT;
+    while (cap < n)
+        cap *= 2;
+
+    if (!grow((void **)&c->bgn,  cap, sizeof(double))        ||
+        !grow((void **)&c->dst,  cap, sizeof(double))        ||
+        !grow((void **)&c->act,  cap, sizeof(double))        ||
+        !grow((void **)&c->start, cap, sizeof(double))       ||
+        !grow((void **)&c->elapsed, cap, sizeof(double))     ||
+        !grow((void **)&c->time, cap, sizeof(int))           ||
+        !grow((void **)&c->mask, (cap+31)>>5, sizeof(uint32_t)) ||
+        !grow((void **)&c->mode, cap, sizeof(unsigned char)) ||
+        !grow((void **)&c->type, cap, sizeof(unsigned char)) ||
+        !grow((void **)&c->shape, cap, sizeof(t_ramp_shape)) ||
+        !grow((void **)&c->shaped, cap, sizeof(unsigned char)) ||
+        !grow((void **)&c->queue, cap, sizeof(t_ramp_queue)) ||
+        !grow((void **)&c->member, cap, sizeof(int))         ||
+        !grow((void **)&c->active, cap, sizeof(int))         ||
+        !grow((void **)&c->slot, cap, sizeof(int))           ||
+        !grow((void **)&c->dirty, cap, sizeof(int))          ||
+        !grow((void **)&c->dirtybit, (cap+31)>>5, sizeof(uint32_t)) ||
+        !grow((void **)&c->lane, 2*cap, sizeof(int))         ||
+        !grow((void **)&c->k,    cap, sizeof(double)))
+        return false;                       // arrays already grown keep their content and are freed by ramp_core_free()
+
+    for (i=c->cap;i<cap;i++) {
+        c->bgn[i]  = 0;                     // set initial value in the instance's data structure
+        c->dst[i]  = 0;                     // set initial value in the instance's data structure
+        c->act[i]  = 0;                     // set initial value in the instance's data structure
+        c->start[i] = 0;                    // set initial value in the instance's data structure
+        c->elapsed[i] = 0;                  // set initial value in the instance's data structure
+        c->time[i] = c->deftime;            // set initial value in the instance's data structure
+        c->mode[i] = c->defmode;            // set initial value in the instance's data structure
+        c->type[i] = TYPE_LONG;             // set initial value in the instance's data structure
+        memset(c->shape+i, 0, sizeof(t_ramp_shape));
+        c->shaped[i] = 0;                   // set initial value in the instance's data structure
+        memset(c->queue+i, 0, sizeof(t_ramp_queue));
+        c->queue[i].pos = -1;               // set initial value in the instance's data structure
+        c->member[i] = -1;                  // set initial value in the instance's data structure
+        c->slot[i] = -1;                    // set initial value in the instance's data structure
+        c->dirtybit[i>>5] &= ~((uint32_t)1<<(i&31));
+        ramp_core_mask(c, i, true);         // set initial value in the instance's data structure
+    }
+    c->cap = cap;
+    return true;
+}
+
+bool ramp_core_setlen(t_ramp_core *c, long len) {
+    // resize the computed list, the elements dropped from the list are kept for a later longer list except the masked ones which are reset to 0
+    long i;
+    bool ok = ramp_core_reserve(c, len);
+    if (!ok)
+        len = c->cap;
+    for (i=len;i<c->len;i++) {
+        if (!ramp_core_masked(c,i))
+            c->bgn[i] = c->act[i] = c->dst[i] = 0;
+        ramp_core_deactivate(c, i);         // elements out of the list are not updated
+    }
+    for (i=c->len;i<len;i++) {
+        if (c->act[i] != c->dst[i])
+            ramp_core_activate(c, i);       // elements back in the list resume their ramp
+    }
+    if (len > c->fresh) {
+        ramp_core_refresh(c, c->fresh, len);
+        c->fresh = len;
+    }
+    c->len = len;
+    return ok;
+}
+
+void ramp_core_set(t_ramp_core *c, long i, double dst, enum type type) {
+    if (ramp_core_masked(c,i)) {
+        c->bgn[i]  = c->act[i];             // new begin is actual value
+        c->dst[i]  = dst;                   // new destination is the transmitted value
+        c->start[i] = c->now;               // new destination mean new start
+        c->elapsed[i] = 0;
+        c->type[i] = type;                  // new destination has a type
+        c->queue[i].pos = -1;               // a new destination replaces the queue
+        if (c->member[i] >= 0)
+            ramp_core_regroup(c, c->group+c->member[i]);
+        else
+            ramp_core_activate(c, i);
+    }
+}
+
+static void ramp_core_activate(t_ramp_core *c, long i) {
+    // a group is updated from its first element only
+    if (c->member[i] >= 0)
+        i = c->group[c->member[i]].first;
+    if (c->slot[i] < 0) {
+        c->slot[i] = c->nactive;
+        c->active[c->nactive++] = i;
+    }
+}
+
+static void ramp_core_deactivate(t_ramp_core *c, long i) {
+    // the last active element takes the place of the removed one
+    long a = c->slot[i];
+    if (a >= 0) {
+        long last = c->active[--c->nactive];
+        c->active[a] = last;
+        c->slot[last] = a;
+        c->slot[i] = -1;
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+double *ramp_core_pattern(t_ramp_core *c, enum param p, long n) {
+    // buffer for the n values of a new time, mode, mask or curve parameter list, to be filled then applied by ramp_core_apply()
+    t_ramp_pattern *pat = c->pattern+p;
+    if (n < 1)
+        return NULL;
+    if (n > pat->size) {
+        if (!grow((void **)&pat->v, n, sizeof(double)))
+            return NULL;
+        pat->size = n;
+    }
+    pat->n = n;
+    return pat->v;
+}
+
+static void ramp_core_param(t_ramp_core *c, enum param p, long i, double v, bool force) {
+    // set one parameter of one element from a pattern value, force sets the elements never initialized whatever the mask
+    switch (p) {
+        case PARAM_TIME:
+            if (v == PATTERN_SKIP) {
+                if (force) c->time[i] = c->deftime;
+            }
+            else if (force || ramp_core_masked(c,i))
+                c->time[i] = (int)v;
+            break;
+        case PARAM_MODE:
+            if (v == PATTERN_SKIP) {
+                if (force) c->mode[i] = c->defmode;
+            }
+            else if (force || ramp_core_masked(c,i))
+                c->mode[i] = (v<0 || v>=ramp_mode_count()) ? LINEAR : (unsigned char)v;
+            break;
+        case PARAM_MASK:
+            if (v != PATTERN_SKIP)
+                ramp_core_mask(c, i, v != 0);
+            else if (force)
+                ramp_core_mask(c, i, true);
+            break;
+        case PARAM_POWER:
+        case PARAM_OVERSHOOT:
+        case PARAM_AMPLITUDE:
+        case PARAM_PERIOD:
+            if (v == PATTERN_SKIP) {
+                if (force) ramp_core_shape(c, i, p, 0);
+            }
+            else if (force || ramp_core_masked(c,i))
+                ramp_core_shape(c, i, p, v);
+            break;
+        default:
+            break;
+    }
+}
+
+void ramp_core_apply(t_ramp_core *c, enum param p) {
+    // apply a list to the elements of the computed list, the other elements get it when the list grows
+    long i, j;
+    t_ramp_pattern *pat = c->pattern+p;
+    for (i=0,j=0;i<c->len;i++) {
+        ramp_core_param(c, p, i, pat->v[j], false);
+        if (++j == pat->n)
+            j = 0;
+    }
+    c->fresh = c->len;
+}
+
+static void ramp_core_refresh(t_ramp_core *c, long from, long to) {
+    // elements entering the computed list get the last lists received, as if they were sent to every element
+    long i;
+    enum param p;
+    for (i=from;i<to;i++) {
+        bool force = (i >= c->used);
+        ramp_core_param(c, PARAM_MASK, i, c->pattern[PARAM_MASK].v[i%c->pattern[PARAM_MASK].n], force);
+        for (p=0;p<PARAM_COUNT;p++) {
+            if (p != PARAM_MASK)            // the mask first, it decides whether the others apply
+                ramp_core_param(c, p, i, c->pattern[p].v[i%c->pattern[p].n], force);
+        }
+    }
+    if (to > c->used)
+        c->used = to;
+}
+
+void ramp_core_time(t_ramp_core *c, long i, long time) {
+    if (ramp_core_masked(c,i))
+        c->time[i] = time;
+}
+
+void ramp_core_mode(t_ramp_core *c, long i, enum mode mode) {
+    if (ramp_core_masked(c,i))
+        c->mode[i] = (mode<0 || mode>=ramp_mode_count()) ? LINEAR : mode;   // unknown modes are computed as linear
+}
+
+void ramp_core_mask(t_ramp_core *c, long i, bool mask) {
+    if (mask)
+        c->mask[i>>5] |= (uint32_t)1<<(i&31);
+    else
+        c->mask[i>>5] &= ~((uint32_t)1<<(i&31));
+}
+
+void ramp_core_shape(t_ramp_core *c, long i, enum param p, double v) {
+    // one curve parameter of element i, 0 or less is the default of the mode
+    t_ramp_shape *sh = c->shape+i;
+    if (v < 0)
+        v = 0;
+    switch (p) {
+        case PARAM_POWER:       sh->power = v;      break;
+        case PARAM_OVERSHOOT:   sh->overshoot = v;  break;
+        case PARAM_AMPLITUDE:   sh->amplitude = v;  break;
+        case PARAM_PERIOD:      sh->period = v;     break;
+        default:                                    break;
+    }
+    c->shaped[i] = (sh->power != 0 || sh->overshoot != 0 || sh->amplitude != 0 || sh->period != 0);
+}
+
+double ramp_core_getshape(t_ramp_core *c, long i, enum param p) {
+    switch (p) {
+        case PARAM_POWER:       return c->shape[i].power;
+        case PARAM_OVERSHOOT:   return c->shape[i].overshoot;
+        case PARAM_AMPLITUDE:   return c->shape[i].amplitude;
+        case PARAM_PERIOD:      return c->shape[i].period;
+        default:                return 0;
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+t_ramp_segment *ramp_core_queue(t_ramp_core *c, long i, long n) {
+    // buffer for the n segments of element i, to be filled then started by ramp_core_play(), n = 0 empties the queue
+    t_ramp_queue *q = c->queue+i;
+    if (n < 1) {
+        q->n = 0;
+        return NULL;
+    }
+    if (n > q->size) {
+        if (!grow((void **)&q->seg, n, sizeof(t_ramp_segment)))
+            return NULL;
+        q->size = n;
+    }
+    q->n = n;
+    return q->seg;
+}
+
+static void ramp_core_segment(t_ramp_core *c, long i, double bgn, double start) {
+    // element i ramps from bgn at time start, along the current segment of its queue
+    t_ramp_queue *q = c->queue+i;
+    const t_ramp_segment *seg = q->seg+q->pos;
+    c->bgn[i] = bgn;
+    c->start[i] = start;
+    c->elapsed[i] = 0;
+    c->time[i] = seg->time;
+    c->type[i] = seg->type;
+    if (q->dir > 0) {
+        c->dst[i] = seg->dst;
+        c->mode[i] = seg->mode;
+    }
+    else {
+        // backward: the same curve from its end, which is the mirror mode from the other side
+        c->dst[i] = (q->pos > 0) ? seg[-1].dst : q->origin;
+        c->mode[i] = ramp_mode_mirror(seg->mode);
+    }
+}
+
+void ramp_core_play(t_ramp_core *c, long i) {
+    // start the queue of element i from its actual value, now
+    t_ramp_queue *q = c->queue+i;
+    if (!ramp_core_masked(c,i) || c->member[i] >= 0)
+        return;                             // the elements of a group move with it
+    if (q->n == 0) {
+        q->pos = -1;                        // the current segment is finished as a simple ramp
+        return;
+    }
+    q->pos = 0;
+    q->dir = 1;
+    q->origin = c->act[i];
+    ramp_core_segment(c, i, c->act[i], c->now);
+    ramp_core_activate(c, i);
+}
+
+void ramp_core_loop(t_ramp_core *c, long i, enum loop loop) {
+    t_ramp_queue *q = c->queue+i;
+    // a queue going backward when its loop is turned off ends after its first segment
+    q->loop = (loop < LOOP_OFF || loop > LOOP_PINGPONG) ? LOOP_OFF : loop;
+}
+
+static void ramp_core_advance(t_ramp_core *c, long i) {
+    // the segments of element i which ended before c->now, each one starting at the end of the previous one so the queue keeps its timing
+    t_ramp_queue *q = c->queue+i;
+    long null = 0;
+    while (q->pos >= 0 && c->now-c->start[i] >= c->time[i]) {
+        double end = c->start[i]+c->time[i];
+        null = (c->time[i] == 0) ? null+1 : 0;
+        if (null > 2*q->n) {
+            q->pos = -1;                    // a loop of null segments would be played forever within one tick
+            return;
+        }
+        if (q->dir > 0) {
+            if (q->pos+1 < q->n)
+                q->pos++;
+            else if (q->loop == LOOP_ON)
+                q->pos = 0;
+            else if (q->loop == LOOP_PINGPONG)
+                q->dir = -1;                // the last segment again, backward
+            else {
+                q->pos = -1;                // the element ends on its last segment
+                return;
+            }
+        }
+        else if (q->pos > 0)
+            q->pos--;
+        else if (q->loop == LOOP_PINGPONG)
+            q->dir = 1;                     // the first segment again, forward
+        else {
+            q->pos = -1;
+            return;
+        }
+        ramp_core_segment(c, i, c->dst[i], end);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static bool ramp_core_arrive(t_ramp_core *c, long i) {
+    // element i, or every element of its group, takes its destination, returns true if a value changed
+    long j, first = i, last = i+1;
+    bool changed = false;
+    if (c->member[i] >= 0) {
+        first = c->group[c->member[i]].first;
+        last = first+c->group[c->member[i]].dim;
+    }
+    for (j=first;j<last;j++) {
+        if (c->act[j] != c->dst[j]) {
+            c->act[j] = c->dst[j];
+            ramp_core_touch(c, j);
+            changed = true;
+        }
+    }
+    return changed;
+}
+
+static void ramp_core_regroup(t_ramp_core *c, t_ramp_group *g) {
+    // every element of the group starts again from its actual value, the time and mode of the group are the ones of its first element
+    long j;
+    for (j=g->first;j<g->first+g->dim;j++) {
+        c->bgn[j] = c->act[j];
+        c->start[j] = c->now;
+        c->elapsed[j] = 0;
+        c->queue[j].pos = -1;
+    }
+    g->fresh = true;
+    ramp_core_activate(c, g->first);
+}
+
+static void ramp_core_ungroup(t_ramp_core *c, long n) {
+    // the elements of group n move alone again, the moving ones go on from where they are for the rest of the time of the group
+    t_ramp_group *g = c->group+n;
+    long j, f = g->first;
+    bool running = (c->slot[f] >= 0);
+    double rest = c->time[f]-(c->now-c->start[f]);
+
+    ramp_core_deactivate(c, f);
+    for (j=f;j<f+g->dim;j++) {
+        c->member[j] = -1;
+        if (running && c->act[j] != c->dst[j]) {
+            c->bgn[j] = c->act[j];
+            c->start[j] = c->now;
+            c->time[j] = (rest > 0) ? (int)rest : 0;
+            c->mode[j] = c->mode[f];
+            ramp_core_activate(c, j);
+        }
+    }
+    ramp_vector_free(g);
+    *g = c->group[--c->ngroup];             // the last group takes the place of the removed one
+    for (j=g->first;g!=c->group+c->ngroup&&j<g->first+g->dim;j++)
+        c->member[j] = n;
+}
+
+bool ramp_core_vector(t_ramp_core *c, long first, long dim, enum vector kind) {
+    // group the dim elements from first so they share one progression, dim < 2 ungroups the elements of the group holding first
+    long j, end = first+((dim < 2) ? 1 : dim);
+    t_ramp_group *g;
+    bool moving = false;
+
+    if (first < 0 || kind < VECTOR_LERP || kind >= VECTOR_COUNT)
+        return false;
+    if (dim >= 2 && ((kind == VECTOR_SLERP && dim != 4) || (kind == VECTOR_OKLAB && dim != 3)))
+        return false;                       // a quaternion has 4 elements, a colour 3
+    if (!ramp_core_reserve(c, end))
+        return false;
+    for (j=first;j<end;j++) {
+        if (c->member[j] >= 0)
+            ramp_core_ungroup(c, c->member[j]);     // the groups overlapping the new one are dissolved
+    }
+    if (dim < 2)
+        return true;
+    if (c->ngroup == c->gsize) {
+        long size = (c->gsize < 4) ? 4 : 2*c->gsize;
+        if (!grow((void **)&c->group, size, sizeof(t_ramp_group)))
+            return false;
+        c->gsize = size;
+    }
+    g = c->group+c->ngroup;
+    memset(g, 0, sizeof(t_ramp_group));
+    g->first = first;
+    g->dim = dim;
+    g->kind = kind;
+    for (j=first;j<end;j++) {
+        moving |= (c->slot[j] >= 0);
+        ramp_core_deactivate(c, j);         // the group is updated from its first element
+        c->member[j] = c->ngroup;
+    }
+    c->ngroup++;
+    if (moving)
+        ramp_core_regroup(c, g);            // the moving elements go on together from where they are
+    return true;
+}
+
+bool ramp_core_via(t_ramp_core *c, long first, const double *v, long n) {
+    // n/dim points the spline of the group starting at first goes through, from its next ramp
+    t_ramp_group *g;
+    if (first < 0 || first >= c->cap || c->member[first] < 0)
+        return false;
+    g = c->group+c->member[first];
+    if (g->first != first || n%g->dim != 0)
+        return false;
+    if (n > g->vsize) {
+        if (!grow((void **)&g->via, n, sizeof(double)))
+            return false;
+        g->vsize = n;
+    }
+    if (n > 0)
+        memcpy(g->via, v, n*sizeof(double));
+    g->nvia = n/g->dim;
+    return true;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_core_clean(t_ramp_core *c) {
+    // forget the changed elements, once they have been output
+    long d;
+    for (d=0;d<c->ndirty;d++)
+        c->dirtybit[c->dirty[d]>>5] &= ~((uint32_t)1<<(c->dirty[d]&31));
+    c->ndirty = 0;
+}
+
+bool ramp_core_jump(t_ramp_core *c) {
+    // if ramp time = 0, set result directly, return true if no element is still ramping
+    long a, i;
+    bool noramp = true;
+
+    for (a=0;a<c->nactive;) {
+        i = c->active[a];
+        if (c->time[i] == 0 && c->queue[i].pos < 0) {
+            ramp_core_arrive(c, i);
+            ramp_core_deactivate(c, i);     // the last active element is now at a
+            continue;
+        }
+        if (c->act[i] != c->dst[i] || c->queue[i].pos >= 0 || c->member[i] >= 0)
+            noramp = false;                 // a queue goes on after its first segment, ramp_core_update() plays its null ones
+        a++;
+    }
+    return noramp;
+}
+
+void ramp_core_shift(t_ramp_core *c, double dt) {
+    // delay the running ramps by dt ms, after a pause
+    long a;
+    for (a=0;a<c->nactive;a++)
+        c->start[c->active[a]] += dt;
+}
+
+long ramp_core_update(t_ramp_core *c, double now) {
+    // only the active elements are visited, an element leaves the active list when its ramp is done
+    // the progressions come from the time elapsed since the start of each ramp, so late ticks skip values instead of stretching the ramps
+    // an element playing a queue goes on with its next segments when its ramp is done, without leaving the active list
+    long a, i, m, n = 0, nm = ramp_mode_count();
+    bool output = false;
+    bool finished = true;
+    const double *bgn = c->bgn;
+    const double *dst = c->dst;
+    double *act = c->act;
+    const double *start = c->start;
+    int *time = c->time;
+    const unsigned char *mode = c->mode;
+    int *moving = c->lane;
+    int *group = c->lane+c->cap;
+    double *k = c->k;
+    long count[MODE_MAX+1];
+
+    c->now = now;
+
+    //-------- collect the elements which are still moving
+    memset(count, 0, (nm+1)*sizeof(long));
+    for (a=0;a<c->nactive;) {
+        i = c->active[a];
+        if (c->member[i] >= 0) {
+            // a group moves from its first element, which takes one place in the block kernels for all the elements
+            if (now-start[i] < time[i]) {
+                output = true;
+                finished = false;
+                a++;
+                if (c->shaped[i]) {
+                    double kk = (now-start[i])/time[i];
+                    ramp_vector_calc(c, c->group+c->member[i], ramp_calc_shape((kk < 0) ? 0 : kk, mode[i], c->shape+i));
+                    continue;
+                }
+                moving[n++] = i;
+                count[mode[i]+1]++;
+                continue;
+            }
+            if (ramp_core_arrive(c, i))
+                output = true;
+            if (c->reset_time==1)
+                time[i] = 0;
+            ramp_core_deactivate(c, i);
+            continue;
+        }
+        if (c->queue[i].pos >= 0 && now-start[i] >= time[i])
+            ramp_core_advance(c, i);
+        if (dst[i] != bgn[i]) {
+            // not act != dst: an overshooting curve may pass exactly on its destination before the end of its ramp
+            output = true;
+            if (now-start[i] < time[i]) {
+                finished = false;
+                a++;
+                if (c->shaped[i]) {
+                    // an element with its own curve parameters is computed alone, the others keep their block kernels
+                    double kk = (now-start[i])/time[i];
+                    act[i] = bgn[i] + (dst[i]-bgn[i])*ramp_calc_shape((kk < 0) ? 0 : kk, mode[i], c->shape+i);
+                    ramp_core_touch(c, i);
+                    continue;
+                }
+                moving[n++] = i;
+                count[mode[i]+1]++;
+                continue;
+            }
+            act[i] = dst[i];
+            ramp_core_touch(c, i);
+            if (c->reset_time==1)
+                time[i] = 0;
+        }
+        else {
+            // a queue segment which holds its value, or a queue ending on such a segment
+            if (act[i] != dst[i]) {
+                act[i] = dst[i];
+                ramp_core_touch(c, i);
+                output = true;
+            }
+            if (c->queue[i].pos >= 0) {
+                finished = false;
+                a++;
+                continue;
+            }
+        }
+        ramp_core_deactivate(c, i);         // the last active element is now at a
+    }
+    if (n == 0)
+        return (output ? RAMP_OUTPUT : 0) | (finished ? 0 : RAMP_RUNNING);
+
+    //-------- group them by interpolation mode, so each mode is computed by one block kernel
+    for (m=0;m<nm;m++)
+        count[m+1] += count[m];
+    for (i=0;i<n;i++) {
+        long j = count[mode[moving[i]]]++;
+        group[j] = moving[i];
+        k[j] = (now-start[moving[i]])/time[moving[i]];
+        if (k[j] < 0)
+            k[j] = 0;                       // started after now, the clock went back
+    }
+    for (m=0,i=0;m<nm;m++) {
+        if (count[m] > i) {
+            if (c->lut && c->lut->table[m])
+                ramp_lut_block(c->lut, m, k+i, k+i, count[m]-i);
+            else
+                ramp_calc_block(m, k+i, k+i, count[m]-i);
+        }
+        i = count[m];
+    }
+
+    //-------- interpolate
+    for (i=0;i<n;i++) {
+        long j = group[i];
+        if (c->member[j] >= 0) {
+            ramp_vector_calc(c, c->group+c->member[j], k[i]);
+            continue;
+        }
+        act[j] = bgn[j] + (dst[j]-bgn[j])*k[i];
+        ramp_core_touch(c, j);
+    }
+    return (output ? RAMP_OUTPUT : 0) | (finished ? 0 : RAMP_RUNNING);
+}
+
+static double ramp_core_reach(double e1, double e2, double d) {
+    // time (in progression units) for a curve with derivatives e1 and e2 to move by d
+    // second order bound: |e1|t + |e2|t^2/2 = d, so the estimate comes early rather than late
+    e1 = fabs(e1);
+    e2 = fabs(e2);
+    if (e2 < 1e-12)
+        return (e1 < 1e-12) ? 1 : d/e1;
+    return (sqrt(e1*e1+2*e2*d)-e1)/e2;
+}
+
+static double ramp_core_curve(t_ramp_core *c, long i, double k) {
+    // value of element i at progression k, computed the way ramp_core_update() does
+    double e;
+    if (c->lut && c->lut->table[c->mode[i]])
+        ramp_lut_block(c->lut, c->mode[i], &k, &e, 1);
+    else
+        ramp_calc_block(c->mode[i], &k, &e, 1);
+    return c->bgn[i] + (c->dst[i]-c->bgn[i])*e;
+}
+
+double ramp_core_next(t_ramp_core *c, double res, long quant) {
+    // time of the next update which can change the output (in ms), c->now when the elements need every grain
+    // res is the smallest change of a float element worth an update, the int elements change when their rounding does
+    // quant rounds the elements as the output does: 0 as their type, 1 all int, 2 all float
+    long a, j;
+    double next = -1;
+
+    for (a=0;a<c->nactive;a++) {
+        long i = c->active[a];
+        double t = c->time[i];
+        double amp = c->dst[i]-c->bgn[i];
+        double end = c->start[i]+t;
+        double act = c->act[i];
+        double k, e1, e2, h = 1e-4;
+        double wake = end;
+        bool rounded = (quant == 1) || (quant == 0 && c->type[i] == TYPE_LONG);
+        bool queued = (c->queue[i].pos >= 0);
+
+        if (c->member[i] >= 0)
+            return c->now;                  // the groups are updated every grain
+        if (queued && end > c->now && amp == 0) {
+            // a queue segment holding its value: nothing changes before the next segment
+            if (next < 0 || end < next)
+                next = end;
+            continue;
+        }
+        if (t <= 0 || amp == 0 || end <= c->now || !ramp_mode_monotonic(c->mode[i]) || c->shaped[i])
+            return c->now;                  // overshooting, bouncing and parametrized curves are updated every grain
+
+        //-------- int element: the curve is inverted at the next rounding threshold
+        if (rounded) {
+            if (round(act) == round(c->dst[i]) && queued)
+                wake = end;                 // no threshold left, the next segment starts at the end of this one
+            else if (round(act) == round(c->dst[i])) {
+                // no threshold left, but the element ends as soon as its value reaches the destination
+                double lo = c->now, hi = end;
+                for (j=0;j<64&&hi-lo>1e-9;j++) {
+                    double mid = 0.5*(lo+hi);
+                    if (ramp_core_curve(c, i, (mid-c->start[i])/t) == c->dst[i])
+                        hi = mid;
+                    else
+                        lo = mid;
+                }
+                if (next < 0 || lo < next)
+                    next = lo;
+                continue;
+            }
+            k = ramp_calc_inverse((round(act)+((amp > 0) ? 0.5 : -0.5)-c->bgn[i])/amp, c->mode[i]);
+            wake = c->start[i] + k*t - 1e-6;    // a bit early, the crossing is then seen by the first grain after it
+            if (wake < c->now)
+                wake = c->now;
+            if (wake > end)
+                wake = end;
+            // the inversion is exact but the kernels and the tables are not: get back until the rounding has not changed yet
+            for (j=0;j<32;j++) {
+                if (round(ramp_core_curve(c, i, (wake-c->start[i])/t)) == round(act))
+                    break;
+                wake = c->now + (wake-c->now)*0.5;
+            }
+        }
+
+        //-------- float element: a lane which cannot move by res before its end only wakes up at its end
+        else if (res <= 0)
+            return c->now;
+        else if (fabs(c->dst[i]-act) > res) {
+            k = (c->now-c->start[i])/t;
+            if (k < h) k = h;
+            if (k > 1-h) k = 1-h;
+            e1 = ramp_calc(k+h, c->mode[i])-ramp_calc(k-h, c->mode[i]);
+            e2 = ramp_calc(k+h, c->mode[i])-2*ramp_calc(k, c->mode[i])+ramp_calc(k-h, c->mode[i]);
+            wake = c->now + t*ramp_core_reach(e1/(2*h), e2/(h*h), res/fabs(amp));
+            if (wake > end)
+                wake = end;
+            // the estimate ignores the higher derivatives: get back until the curve has not moved by res yet
+            for (j=0;j<32;j++) {
+                if (fabs(ramp_core_curve(c, i, (wake-c->start[i])/t)-act) < res)
+                    break;
+                wake = c->now + (wake-c->now)*0.5;
+            }
+        }
+        if (next < 0 || wake < next)
+            next = wake;
+    }
+    return (next < 0) ? c->now : next;
+}
+
+void ramp_core_perform(t_ramp_core *c, long i, double step, double *out, long n) {
+    // n samples of element i, step ms apart: the signal version of ramp_core_update() for a single element
+    long j, m = n;
+    double t = c->time[i];
+    double bgn = c->bgn[i], amp = c->dst[i]-c->bgn[i];
+    double e = c->elapsed[i];
+
+    if (c->slot[i] >= 0 && (t <= 0 || amp == 0)) {
+        c->act[i] = c->dst[i];
+        ramp_core_deactivate(c, i);
+    }
+    if (c->slot[i] < 0) {
+        for (j=0;j<n;j++)
+            out[j] = c->act[i];
+        return;
+    }
+
+    //-------- progressions of the samples before the end of the ramp, then one block kernel call
+    if (e+(n-1)*step >= t)
+        m = (e >= t) ? 0 : (long)ceil((t-e)/step);
+    for (j=0;j<m;j++)
+        out[j] = (e+j*step)/t;
+    if (c->shaped[i]) {
+        for (j=0;j<m;j++)
+            out[j] = ramp_calc_shape(out[j], c->mode[i], c->shape+i);
+    }
+    else if (c->lut && c->lut->table[c->mode[i]])
+        ramp_lut_block(c->lut, c->mode[i], out, out, m);
+    else
+        ramp_calc_block(c->mode[i], out, out, m);
+    for (j=0;j<m;j++)
+        out[j] = bgn + amp*out[j];
+
+    //-------- the ramp ends in this block
+    if (m < n) {
+        for (j=m;j<n;j++)
+            out[j] = c->dst[i];
+        c->act[i] = c->dst[i];
+        c->elapsed[i] = t;
+        if (c->reset_time==1)
+            c->elapsed[i] = c->time[i] = 0;
+        ramp_core_deactivate(c, i);
+        return;
+    }
+    c->act[i] = out[n-1];
+    c->elapsed[i] = e+n*step;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+long ramp_mode_find(const char *s) {
+    long i, n = ramp_mode_count();
+    for (i=0;i<n;i++) {
+        if (strcmp(s,ramp_mode_name(i))==0)
+            return i;
+    }
+    return -1;
+}
+
+bool ramp_mode_monotonic(long m) {
+    // the curve never goes down, so it can be inverted by ramp_calc_inverse()
+    if (m >= LAST)
+        return ramp_curve_get(m) && ramp_curve_get(m)->monotonic;
+    return m < ELASTIC_IN;
+}
+
+long ramp_mode_mirror(long m) {
+    // the mode whose curve is the curve of m turned by half a turn, e_mirror(k) = 1-e_m(1-k): IN and OUT swap, INOUT and LINEAR stay
+    // a user curve has no mirror and is kept
+    if (m < QUAD_IN || m > BOUNCE_INOUT)
+        return m;
+    switch ((m-QUAD_IN)%3) {
+        case 0:     return m+1;
+        case 1:     return m-1;
+        default:    return m;
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static inline double ipow(double k, double p) {
+    // the integer powers of the named modes as a multiply chain, the others by pow()
+    double k2 = k*k;
+    if (p == 2) return k2;
+    if (p == 3) return k2*k;
+    if (p == 4) return k2*k2;
+    if (p == 5) return k2*k2*k;
+    return pow(k,p);
+}
+
+double powin(double k, double p) {
+    return ipow(k,p);
+}
+
+double powout(double k, double p) {
+    return 1-ipow(1-k,p);
+}
+
+double powinout(double k, double p) {
+    k *= 2;
+    if (k<1)
+        return 0.5*ipow(k,p);
+    return 1-0.5*ipow(2-k,p);
+}
+
+static double back(double k, double s) {
+    return k*k*((s+1)*k-s);
+}
+
+static double elastic(double k, double a, double p) {
+    // ELASTIC_OUT: 1+a*2^(-10k)*sin((k-s)*2pi/p), s is the phase which starts the curve at 0
+    // the decay is lowered by 2^-10 and rescaled so it reaches 0 at k=1: the curve ends at 1 instead of jumping there
+    double s;
+    if (k <= 0)
+        return 0;
+    if (k >= 1)
+        return 1;
+    if (a < 1) {
+        a = 1;
+        s = p/4;
+    }
+    else
+        s = p*asin(1/a)/(2*M_PI);
+    return 1 + a*(pow(2,-10*k)-1./1024)*(1024./1023)*sin((k-s)*(2*M_PI)/p);
+}
+
+double ramp_calc(double k, enum mode m) {
+
+    if (m >= LAST)
+        return ramp_curve_calc(k, m);
+
+    switch (m) {
+        case QUAD_IN:
+            return powin(k,2);
+
+        case QUAD_OUT:
+            return powout(k,2);
+
+        case QUAD_INOUT:
+            return powinout(k,2);
+
+        case CUBIC_IN:
+            return powin(k,3);
+
+        case CUBIC_OUT:
+            return powout(k,3);
+
+        case CUBIC_INOUT:
+            return powinout(k,3);
+
+        case QUARTIC_IN:
+            return powin(k,4);
+
+        case QUARTIC_OUT:
+            return powout(k,4);
+
+        case QUARTIC_INOUT:
+            return powinout(k,4);
+
+        case QUINTIC_IN:
+            return powin(k,5);
+
+        case QUINTIC_OUT:
+            return powout(k,5);
+
+        case QUINTIC_INOUT:
+            return powinout(k,5);
+
+        case SINUSOIDAL_IN:
+            return 1-cos(k*(M_PI/2));
+
+        case SINUSOIDAL_OUT:
+            return sin(k*(M_PI/2));
+
+        case SINUSOIDAL_INOUT:
+            return -0.5*(cos(M_PI*k)-1);
+
+        case EXPONENTIAL_IN:
+            return pow(2,10*(k-1));
+
+        case EXPONENTIAL_OUT:
+            return (1-pow(2,-10*k));
+
+        case EXPONENTIAL_INOUT:
+            k *= 2.;
+            if (k<1)
+                return 0.5*pow(2,10*(k-1));
+            k--;
+            return 0.5*(2-pow(2,-10*k));
+
+        case CIRCULAR_IN:
+            return -(sqrt(1-k*k)-1);
+
+        case CIRCULAR_OUT:
+            k--;
+            return sqrt(1-k*k);
+
+        case CIRCULAR_INOUT:
+            k *= 2;
+            if (k<1)
+                return -0.5*(sqrt(1-k*k)-1);
+            k -= 2;
+            return 0.5*(sqrt(1-k*k)+1);
+
+        case ELASTIC_IN:
+            return 1-elastic(1-k,1,0.3);
+
+        case ELASTIC_OUT:
+            return elastic(k,1,0.3);
+
+        case ELASTIC_INOUT:
+            if (k < 0.5)
+                return 0.5-0.5*elastic(1-2*k,1,0.45);
+            return 0.5+0.5*elastic(2*k-1,1,0.45);
+
+        case BACK_IN:
+            return back(k,1.70158);
+
+        case BACK_OUT:
+            return 1-back(1-k,1.70158);
+
+        case BACK_INOUT:
+            if (k < 0.5)
+                return 0.5*back(2*k,1.70158*1.525);
+            return 1-0.5*back(2-2*k,1.70158*1.525);
+
+        case BOUNCE_IN:
+            return 1-ramp_calc(1-k,BOUNCE_OUT);
+
+        case BOUNCE_OUT:
+            if (k < (1/2.75))
+                return 7.5625*k*k;
+            if (k < (2/2.75)) {
+                k -= 1.5/2.75;
+                return 7.5625*k*k+0.75;
+            }
+            if (k < (2.5/2.75)) {
+                k -= (2.25/2.75);
+                return 7.5625*k*k+0.9375;
+            }
+            k -= (2.625/2.75);
+            return 7.5625*k*k+0.984375;
+
+        case BOUNCE_INOUT:
+            if (k < 0.5) {
+                return ramp_calc(k*2,BOUNCE_IN)*0.5;
+            }
+            return ramp_calc(k*2-1,BOUNCE_OUT)*0.5+0.5;
+            break;
+
+        case LINEAR:
+        default:
+            return k;
+    }
+}
+
+double ramp_calc_shape(double k, enum mode m, const t_ramp_shape *sh) {
+    // ramp_calc() with the curve parameters of an element, a parameter at 0 keeps the default of the mode
+    double p, s, a;
+
+    switch (m) {
+        case QUAD_IN:
+        case CUBIC_IN:
+        case QUARTIC_IN:
+        case QUINTIC_IN:
+            return powin(k,(sh->power > 0) ? sh->power : 2+(m-QUAD_IN)/3);
+
+        case QUAD_OUT:
+        case CUBIC_OUT:
+        case QUARTIC_OUT:
+        case QUINTIC_OUT:
+            return powout(k,(sh->power > 0) ? sh->power : 2+(m-QUAD_OUT)/3);
+
+        case QUAD_INOUT:
+        case CUBIC_INOUT:
+        case QUARTIC_INOUT:
+        case QUINTIC_INOUT:
+            return powinout(k,(sh->power > 0) ? sh->power : 2+(m-QUAD_INOUT)/3);
+
+        case ELASTIC_IN:
+        case ELASTIC_OUT:
+        case ELASTIC_INOUT:
+            a = (sh->amplitude > 0) ? sh->amplitude : 1;
+            p = (sh->period > 0) ? sh->period : (m == ELASTIC_INOUT) ? 0.45 : 0.3;
+            if (m == ELASTIC_IN)
+                return 1-elastic(1-k,a,p);
+            if (m == ELASTIC_OUT)
+                return elastic(k,a,p);
+            if (k < 0.5)
+                return 0.5-0.5*elastic(1-2*k,a,p);
+            return 0.5+0.5*elastic(2*k-1,a,p);
+
+        case BACK_IN:
+        case BACK_OUT:
+        case BACK_INOUT:
+            s = (sh->overshoot > 0) ? sh->overshoot : 1.70158;
+            if (m == BACK_IN)
+                return back(k,s);
+            if (m == BACK_OUT)
+                return 1-back(1-k,s);
+            s *= 1.525;
+            if (k < 0.5)
+                return 0.5*back(2*k,s);
+            return 1-0.5*back(2-2*k,s);
+
+        default:
+            return ramp_calc(k,m);
+    }
+}
+
+double ramp_calc_inverse(double y, enum mode m) {
+    // progression at which ramp_calc() reaches y, for the monotonic modes only (-1 for the others)
+    if (m >= LAST)
+        return ramp_curve_inverse(y, m);
+    y = (y < 0) ? 0 : (y > 1) ? 1 : y;
+    switch (m) {
+        case LINEAR:
+            return y;
+
+        case QUAD_IN:
+        case CUBIC_IN:
+        case QUARTIC_IN:
+        case QUINTIC_IN:
+            return pow(y,1./(2+(m-QUAD_IN)/3));
+
+        case QUAD_OUT:
+        case CUBIC_OUT:
+        case QUARTIC_OUT:
+        case QUINTIC_OUT:
+            return 1-pow(1-y,1./(2+(m-QUAD_OUT)/3));
+
+        case QUAD_INOUT:
+        case CUBIC_INOUT:
+        case QUARTIC_INOUT:
+        case QUINTIC_INOUT:
+            if (y < 0.5)
+                return 0.5*pow(2*y,1./(2+(m-QUAD_INOUT)/3));
+            return 1-0.5*pow(2*(1-y),1./(2+(m-QUAD_INOUT)/3));
+
+        case SINUSOIDAL_IN:
+            return acos(1-y)*(2/M_PI);
+
+        case SINUSOIDAL_OUT:
+            return asin(y)*(2/M_PI);
+
+        case SINUSOIDAL_INOUT:
+            return acos(1-2*y)/M_PI;
+
+        case EXPONENTIAL_IN:
+            return (y <= pow(2,-10)) ? 0 : 1+log2(y)/10;
+
+        case EXPONENTIAL_OUT:
+            return (y >= 1-pow(2,-10)) ? 1 : -log2(1-y)/10;
+
+        case EXPONENTIAL_INOUT:
+            if (y < 0.5)
+                return (y <= 0.5*pow(2,-10)) ? 0 : 0.5*(1+log2(2*y)/10);
+            return (y >= 1-0.5*pow(2,-10)) ? 1 : 0.5*(1-log2(2-2*y)/10);
+
+        case CIRCULAR_IN:
+            return sqrt(1-(1-y)*(1-y));
+
+        case CIRCULAR_OUT:
+            return 1-sqrt(1-y*y);
+
+        case CIRCULAR_INOUT:
+            if (y < 0.5)
+                return 0.5*sqrt(1-(1-2*y)*(1-2*y));
+            return 1-0.5*sqrt(1-(2*y-1)*(2*y-1));
+
+        default:
+            return -1;
+    }
+}
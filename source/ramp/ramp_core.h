@@ -0,0 +1,295 @@
+/**
+	ramp_core.h - Max independent interpolation engine of the ramp object
+
+	holds the lanes of a ramp (begin, destination, actual value, progression...)
+	and computes them tick after tick, without any reference to ext.h
+	so it can be shared between externals and driven by headless tools (see bench/ramp_bench.c)
+ */
+
+#ifndef RAMP_CORE_H
+#define RAMP_CORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define MIN_OBJECT 8         // elements allocated by a new ramp, the storage grows on demand
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define MODE_LIST          \
+    X(LINEAR)              \
+    X(QUAD_IN)             \
+    X(QUAD_OUT)            \
+    X(QUAD_INOUT)          \
+    X(CUBIC_IN)            \
+    X(CUBIC_OUT)           \
+    X(CUBIC_INOUT)         \
+    X(QUARTIC_IN)          \
+    X(QUARTIC_OUT)         \
+    X(QUARTIC_INOUT)       \
+    X(QUINTIC_IN)          \
+    X(QUINTIC_OUT)         \
+    X(QUINTIC_INOUT)       \
+    X(SINUSOIDAL_IN)       \
+    X(SINUSOIDAL_OUT)      \
+    X(SINUSOIDAL_INOUT)    \
+    X(EXPONENTIAL_IN)      \
+    X(EXPONENTIAL_OUT)     \
+    X(EXPONENTIAL_INOUT)   \
+    X(CIRCULAR_IN)         \
+    X(CIRCULAR_OUT)        \
+    X(CIRCULAR_INOUT)      \
+    X(ELASTIC_IN)          \
+    X(ELASTIC_OUT)         \
+    X(ELASTIC_INOUT)       \
+    X(BACK_IN)             \
+    X(BACK_OUT)            \
+    X(BACK_INOUT)          \
+    X(BOUNCE_IN)           \
+    X(BOUNCE_OUT)          \
+    X(BOUNCE_INOUT)
+
+enum mode {
+#define X(name) name,
+    MODE_LIST
+#undef X
+    LAST
+};
+
+extern const char *mode_name[];   // names of the interpolation modes, indexed by enum mode
+
+#define MODE_MAX        256 // built-in modes then user curves (see ramp_curve.c), a mode fits in an unsigned char
+#define CURVE_SIZE      1024    // number of intervals of the table of a user curve
+
+typedef struct _ramp_curve {
+    char        *name;              // name used by the mode messages
+    long        mode;               // number of the curve, from LAST
+    bool        monotonic;          // never goes down from 0 to 1, so it can be inverted
+    double      table[CURVE_SIZE+1];    // the curve sampled from 0 to 1
+} t_ramp_curve;
+
+typedef struct _ramp_curves {
+    long        n;                  // number of user curves
+    t_ramp_curve *curve[MODE_MAX-LAST];     // user curves, indexed by mode-LAST
+    t_ramp_curve *retired[MODE_MAX-LAST];   // previous version of each curve, freed when it is defined again
+} t_ramp_curves;
+
+enum type {
+    TYPE_LONG,              // element received as an int
+    TYPE_FLOAT              // element received as a float
+};
+
+#define LUT_MIN_ORDER   4   // smallest easing table: 16 intervals
+#define LUT_MAX_ORDER   16  // largest easing table: 65536 intervals
+
+typedef struct _ramp_lut {
+    long        size;               // number of intervals, a power of two
+    double      *table[MODE_MAX];   // size+1 samples per mode, NULL for the modes which are always computed and the user curves
+} t_ramp_lut;
+
+enum param {
+    PARAM_TIME,             // ramp times, in ms
+    PARAM_MODE,             // interpolation modes
+    PARAM_MASK,             // mask flags
+    PARAM_POWER,            // exponent of the quad to quintic modes
+    PARAM_OVERSHOOT,        // overshoot of the back modes
+    PARAM_AMPLITUDE,        // amplitude of the elastic modes
+    PARAM_PERIOD,           // period of the elastic modes
+    PARAM_COUNT
+};
+
+extern const char *param_name[];  // names of the parameter messages, indexed by enum param
+
+typedef struct _ramp_shape {
+    double      power;      // exponent of the quad to quintic modes (0 = 2 to 5 as named)
+    double      overshoot;  // overshoot of the back modes (0 = 1.70158)
+    double      amplitude;  // amplitude of the elastic modes (0 = 1)
+    double      period;     // period of the elastic modes (0 = 0.3, 0.45 for ELASTIC_INOUT)
+} t_ramp_shape;
+
+typedef struct _ramp_segment {
+    double      dst;        // target of the segment
+    int         time;       // length of the segment (in ms)
+    unsigned char mode;     // interpolation mode of the segment (enum mode)
+    unsigned char type;     // type of the target (enum type)
+} t_ramp_segment;
+
+enum loop {
+    LOOP_OFF,               // the queue stops after its last segment
+    LOOP_ON,                // the first segment follows the last one
+    LOOP_PINGPONG           // the segments are played backward then forward again
+};
+
+typedef struct _ramp_queue {
+    t_ramp_segment *seg;    // segments of the element, played one after the other
+    long        n;          // number of segments
+    long        size;       // number of allocated segments
+    long        pos;        // segment being played, -1 if the element is not playing its queue
+    char        dir;        // 1 forward, -1 backward (ping-pong)
+    char        loop;       // what happens after the last segment (enum loop)
+    double      origin;     // value of the element when the queue started, the target of the first segment played backward
+} t_ramp_queue;
+
+enum vector {
+    VECTOR_LERP,            // every element along the curve of the group
+    VECTOR_SLERP,           // quaternion x y z w along the great circle, the shortest way
+    VECTOR_OKLAB,           // sRGB colour r g b through the OKLab perceptual space, 0..1 as floats or 0..255 as ints
+    VECTOR_SPLINE,          // point along a Catmull-Rom spline through the via points, at constant speed
+    VECTOR_COUNT
+};
+
+extern const char *vector_name[];   // names of the vector modes, indexed by enum vector
+
+#define SPLINE_STEPS    32  // arc length samples per spline span
+
+typedef struct _ramp_group {
+    long        first;      // first element of the group, which holds the time, mode and progression of all
+    long        dim;        // number of consecutive elements
+    enum vector kind;       // how the elements move together
+    bool        fresh;      // the ramp restarted, the cache is computed again by the next update
+    double      *via;       // spline: points passed through between the begin and the destination, dim values each
+    long        nvia;       // spline: number of via points
+    long        vsize;      // number of allocated via values
+    double      *cache;     // begin and destination in the space of the group, or the spline points then its arc lengths
+    long        csize;      // number of allocated cache values
+    double      length;     // spline: total arc length
+    double      theta;      // slerp: angle between the begin and the destination
+} t_ramp_group;
+
+#define PATTERN_SKIP LONG_MIN   // pattern value leaving the element unchanged
+
+typedef struct _ramp_pattern {
+    long        n;          // number of values of the last list
+    long        size;       // number of allocated values
+    double      *v;         // values repeated over the elements, element i uses v[i%n]
+} t_ramp_pattern;
+
+typedef struct _ramp_core {
+    long        len;        // length of the computed list
+    long        cap;        // number of allocated elements
+    long        used;       // number of elements initialized at least once
+    long        fresh;      // elements from this one need the last time, mode and mask lists before being used
+    long        deftime;    // time of the elements never set
+    enum mode   defmode;    // mode of the elements never set
+    t_ramp_pattern pattern[PARAM_COUNT];    // last time, mode and mask lists received
+    long        grain;      // interval beetween updates (in ms)
+    char        reset_time; // reset time to 0 when a ramp is done
+    const t_ramp_lut *lut;  // shared easing tables, NULL to compute every curve
+    double      *bgn;       // beginning of the ramps
+    double      *dst;       // end of the ramps
+    double      *act;       // actual values
+    double      now;        // time of the last update, or of the last message if later (in ms)
+    double      *start;     // time at which the ramps started (in ms), the progression is now-start
+    double      *elapsed;   // progression of the signal ramps (in ms), with the fraction of the last sample
+    int         *time;      // length of the ramps (in ms)
+    uint32_t    *mask;      // bitset of the masked elements, a set bit means the element can be changed
+    unsigned char *mode;    // type of interpolation: linear, etc... (enum mode)
+    unsigned char *type;    // type of data TYPE_FLOAT or TYPE_LONG (enum type)
+    t_ramp_shape *shape;    // curve parameters of each element
+    unsigned char *shaped;  // the element has a curve parameter other than the default, it is computed by ramp_calc_shape()
+    t_ramp_queue *queue;    // segments following the current ramp of each element
+    int         *member;    // index of the group of each element, -1 if the element moves alone
+    t_ramp_group *group;    // groups of elements sharing one progression
+    long        ngroup;     // number of groups
+    long        gsize;      // number of allocated groups
+    int         *active;    // indexes of the elements which have to be updated, in no particular order
+    int         *slot;      // position of each element in active, -1 if the element is idle
+    long        nactive;    // number of active elements
+    int         *dirty;     // indexes of the elements whose value changed since the last ramp_core_clean()
+    uint32_t    *dirtybit;  // bitset of the elements listed in dirty
+    long        ndirty;     // number of changed elements
+    int         *lane;      // scratch: moving elements, then the same elements grouped by mode
+    double      *k;         // scratch: progressions (0..1) of the grouped elements, then their interpolation
+} t_ramp_core;
+
+enum kernel {
+    KERNEL_SCALAR,          // one ramp_calc() call per element
+    KERNEL_SSE2,            // 2 elements per instruction
+    KERNEL_AVX2             // 4 elements per instruction
+};
+
+extern const char *kernel_name[];   // names of the kernel instruction sets, indexed by enum kernel
+
+// flags returned by ramp_core_update()
+#define RAMP_OUTPUT     1   // at least one element moved during the tick
+#define RAMP_RUNNING    2   // at least one element still has to move
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ramp_core_new(t_ramp_core *c, long time, enum mode mode, long grain);
+void ramp_core_free(t_ramp_core *c);
+
+bool ramp_core_reserve(t_ramp_core *c, long n);
+bool ramp_core_setlen(t_ramp_core *c, long len);
+void ramp_core_set(t_ramp_core *c, long i, double dst, enum type type);
+double *ramp_core_pattern(t_ramp_core *c, enum param p, long n);
+void ramp_core_apply(t_ramp_core *c, enum param p);
+void ramp_core_time(t_ramp_core *c, long i, long time);
+void ramp_core_mode(t_ramp_core *c, long i, enum mode mode);
+void ramp_core_mask(t_ramp_core *c, long i, bool mask);
+void ramp_core_shape(t_ramp_core *c, long i, enum param p, double v);
+double ramp_core_getshape(t_ramp_core *c, long i, enum param p);
+t_ramp_segment *ramp_core_queue(t_ramp_core *c, long i, long n);
+void ramp_core_play(t_ramp_core *c, long i);
+void ramp_core_loop(t_ramp_core *c, long i, enum loop loop);
+bool ramp_core_vector(t_ramp_core *c, long first, long dim, enum vector kind);
+bool ramp_core_via(t_ramp_core *c, long first, const double *v, long n);
+
+static inline bool ramp_core_masked(t_ramp_core *c, long i) {
+    return (c->mask[i>>5]>>(i&31))&1;
+}
+
+static inline void ramp_core_touch(t_ramp_core *c, long i) {
+    // list an element whose actual value changed
+    if (!((c->dirtybit[i>>5]>>(i&31))&1)) {
+        c->dirtybit[i>>5] |= (uint32_t)1<<(i&31);
+        c->dirty[c->ndirty++] = i;
+    }
+}
+
+void ramp_core_clean(t_ramp_core *c);
+bool ramp_core_jump(t_ramp_core *c);
+void ramp_core_shift(t_ramp_core *c, double dt);
+long ramp_core_update(t_ramp_core *c, double now);
+double ramp_core_next(t_ramp_core *c, double res, long quant);
+void ramp_core_perform(t_ramp_core *c, long i, double step, double *out, long n);
+
+long ramp_mode_find(const char *s);
+long ramp_mode_count(void);
+const char *ramp_mode_name(long m);
+bool ramp_mode_monotonic(long m);
+long ramp_mode_mirror(long m);
+
+double powin(double k, double p);
+double powout(double k, double p);
+double powinout(double k, double p);
+double ramp_calc(double k, enum mode m);
+double ramp_calc_shape(double k, enum mode m, const t_ramp_shape *sh);
+double ramp_calc_inverse(double y, enum mode m);
+
+long ramp_kernel_select(long level);
+void ramp_calc_block(enum mode m, const double *k, double *e, long n);
+
+long ramp_curve_bezier(const char *name, double x1, double y1, double x2, double y2);
+long ramp_curve_points(const char *name, const double *x, const double *y, long n);
+const t_ramp_curve *ramp_curve_get(long m);
+t_ramp_curves *ramp_curves(void);
+void ramp_curves_share(t_ramp_curves *shared);
+double ramp_curve_calc(double k, long m);
+void ramp_curve_block(long m, const double *k, double *e, long n);
+double ramp_curve_inverse(double y, long m);
+
+void ramp_vector_free(t_ramp_group *g);
+void ramp_vector_calc(t_ramp_core *c, t_ramp_group *g, double e);
+
+bool ramp_lut_mode(enum mode m);
+long ramp_lut_size(long size);
+const t_ramp_lut *ramp_lut_get(long size);
+void ramp_lut_block(const t_ramp_lut *lut, enum mode m, const double *k, double *e, long n);
+
+#endif
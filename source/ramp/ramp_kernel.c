@@ -0,0 +1,188 @@
+/**
+	ramp_kernel.c - block evaluation of the interpolation modes
+
+	ramp_calc_block() evaluates one interpolation mode over a block of progressions,
+	the instruction set (scalar, SSE2 or AVX2) is chosen at runtime by ramp_kernel_select()
+ */
+
+#include <math.h>
+
+#include "ramp_core.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define KERNEL_X86
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+const char *kernel_name[] = { "scalar", "sse2", "avx2" };
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static void ramp_calc_block_scalar(enum mode m, const double *k, double *e, long n) {
+    long i;
+    for (i=0;i<n;i++)
+        e[i] = ramp_calc(k[i],m);
+}
+
+#ifdef KERNEL_X86
+
+//-------- SSE2, 2 doubles per vector
+
+#define KFN(name)       name##_sse2
+#ifdef _MSC_VER
+#define KATTR
+#else
+#define KATTR           __attribute__((target("sse2")))
+#endif
+#define V               __m128d
+#define VN              2
+#define VSET1(a)        _mm_set1_pd(a)
+#define VLOAD(p)        _mm_loadu_pd(p)
+#define VSTORE(p,a)     _mm_storeu_pd(p,a)
+#define VADD(a,b)       _mm_add_pd(a,b)
+#define VSUB(a,b)       _mm_sub_pd(a,b)
+#define VMUL(a,b)       _mm_mul_pd(a,b)
+#define VSQRT(a)        _mm_sqrt_pd(a)
+#define VLT(a,b)        _mm_cmplt_pd(a,b)
+#define VSEL(m,a,b)     _mm_or_pd(_mm_and_pd(m,a),_mm_andnot_pd(m,b))
+#define VFLOOR(a)       vfloor_sse2(a)
+#define VEXP2I(a)       vexp2i_sse2(a)
+
+static inline KATTR __m128d vfloor_sse2(__m128d x) {
+    // no round instruction before SSE4.1: truncate then correct the negative values
+    __m128d t = _mm_cvtepi32_pd(_mm_cvttpd_epi32(x));
+    return _mm_sub_pd(t,_mm_and_pd(_mm_cmpgt_pd(t,x),_mm_set1_pd(1.)));
+}
+
+static inline KATTR __m128d vexp2i_sse2(__m128d n) {
+    // 2^n for integer n in [-1022,1023], written in the exponent bits
+    __m128i i = _mm_add_epi32(_mm_cvttpd_epi32(n),_mm_set1_epi32(1023));
+    i = _mm_unpacklo_epi32(i,_mm_setzero_si128());
+    return _mm_castsi128_pd(_mm_slli_epi64(i,52));
+}
+
+#include "ramp_kernel_impl.h"
+
+#undef KFN
+#undef KATTR
+#undef V
+#undef VN
+#undef VSET1
+#undef VLOAD
+#undef VSTORE
+#undef VADD
+#undef VSUB
+#undef VMUL
+#undef VSQRT
+#undef VLT
+#undef VSEL
+#undef VFLOOR
+#undef VEXP2I
+
+//-------- AVX2, 4 doubles per vector
+
+#define KFN(name)       name##_avx2
+#ifdef _MSC_VER
+#define KATTR
+#else
+#define KATTR           __attribute__((target("avx2")))
+#endif
+#define V               __m256d
+#define VN              4
+#define VSET1(a)        _mm256_set1_pd(a)
+#define VLOAD(p)        _mm256_loadu_pd(p)
+#define VSTORE(p,a)     _mm256_storeu_pd(p,a)
+#define VADD(a,b)       _mm256_add_pd(a,b)
+#define VSUB(a,b)       _mm256_sub_pd(a,b)
+#define VMUL(a,b)       _mm256_mul_pd(a,b)
+#define VSQRT(a)        _mm256_sqrt_pd(a)
+#define VLT(a,b)        _mm256_cmp_pd(a,b,_CMP_LT_OQ)
+#define VSEL(m,a,b)     _mm256_blendv_pd(b,a,m)
+#define VFLOOR(a)       _mm256_floor_pd(a)
+#define VEXP2I(a)       vexp2i_avx2(a)
+
+static inline KATTR __m256d vexp2i_avx2(__m256d n) {
+    // 2^n for integer n in [-1022,1023], written in the exponent bits
+    __m256i i = _mm256_cvtepi32_epi64(_mm256_cvtpd_epi32(n));
+    i = _mm256_add_epi64(i,_mm256_set1_epi64x(1023));
+    return _mm256_castsi256_pd(_mm256_slli_epi64(i,52));
+}
+
+#include "ramp_kernel_impl.h"
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static long kernel_support(void) {
+    // best instruction set supported by the cpu and the os
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info,0);
+    if (info[0] >= 7) {
+        __cpuid(info,1);
+        if ((info[2]&(1<<27)) && (info[2]&(1<<28)) && ((_xgetbv(0)&6) == 6)) {   // osxsave, avx and ymm state enabled
+            __cpuidex(info,7,0);
+            if (info[1]&(1<<5))
+                return KERNEL_AVX2;
+        }
+    }
+    __cpuid(info,1);
+    return (info[3]&(1<<26)) ? KERNEL_SSE2 : KERNEL_SCALAR;
+#else
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return KERNEL_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return KERNEL_SSE2;
+    return KERNEL_SCALAR;
+#endif
+}
+
+#else
+
+static long kernel_support(void) {
+    return KERNEL_SCALAR;
+}
+
+#endif
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static void (*kernel_block)(enum mode m, const double *k, double *e, long n) = ramp_calc_block_scalar;
+static long kernel_level = -1;
+
+long ramp_kernel_select(long level) {
+    // use the requested instruction set, or the best one available if not supported or level < 0
+    long support = kernel_support();
+    if (level < 0 || level > support)
+        level = support;
+
+    switch (level) {
+#ifdef KERNEL_X86
+        case KERNEL_AVX2:
+            kernel_block = ramp_calc_block_avx2;
+            break;
+        case KERNEL_SSE2:
+            kernel_block = ramp_calc_block_sse2;
+            break;
+#endif
+        default:
+            level = KERNEL_SCALAR;
+            kernel_block = ramp_calc_block_scalar;
+            break;
+    }
+    kernel_level = level;
+    return level;
+}
+
+void ramp_calc_block(enum mode m, const double *k, double *e, long n) {
+    if (m >= LAST) {
+        ramp_curve_block(m,k,e,n);          // user curves are tables
+        return;
+    }
+    if (kernel_level < 0)
+        ramp_kernel_select(-1);
+    kernel_block(m,k,e,n);
+}
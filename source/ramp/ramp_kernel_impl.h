@@ -0,0 +1,189 @@
+/**
+	ramp_kernel_impl.h - vectorized easing kernels, included once per instruction set by ramp_kernel.c
+
+	before including this file, ramp_kernel.c defines:
+        KFN(name)       decorated function name for this instruction set
+        KATTR           function attribute enabling the instruction set
+        V, VN           vector type of doubles and its number of lanes
+        VSET1, VLOAD, VSTORE, VADD, VSUB, VMUL, VSQRT, VLT, VSEL, VFLOOR, VEXP2I
+
+	every kernel evaluates one interpolation mode over a block of progressions k (0..1),
+	e may be the same array as k, the remaining elements of a block are computed by ramp_calc
+ */
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static inline KATTR V KFN(vpow)(V k, int p) {
+    // small integer powers as a multiply chain
+    V k2 = VMUL(k,k);
+    switch (p) {
+        case 2:  return k2;
+        case 3:  return VMUL(k2,k);
+        case 4:  return VMUL(k2,k2);
+        default: return VMUL(VMUL(k2,k2),k);
+    }
+}
+
+static inline KATTR V KFN(vpowout)(V k, int p) {
+    V one = VSET1(1.);
+    return VSUB(one,KFN(vpow)(VSUB(one,k),p));
+}
+
+static inline KATTR V KFN(vpowinout)(V k, int p) {
+    V one = VSET1(1.);
+    V half = VSET1(0.5);
+    V k2 = VADD(k,k);
+    V lo = VMUL(half,KFN(vpow)(k2,p));
+    V hi = VSUB(one,VMUL(half,KFN(vpow)(VSUB(VSET1(2.),k2),p)));   // 2-k >= 0 on the upper half, no fabs needed
+    return VSEL(VLT(k2,one),lo,hi);
+}
+
+static inline KATTR V KFN(vsin)(V x) {
+    // sin(x) for x in [-pi/2,pi/2], Taylor series up to x^19, error < 4e-14
+    V x2 = VMUL(x,x);
+    V r = VSET1(1./121645100408832000.);
+    r = VADD(VMUL(r,x2),VSET1(-1./355687428096000.));
+    r = VADD(VMUL(r,x2),VSET1(1./1307674368000.));
+    r = VADD(VMUL(r,x2),VSET1(-1./6227020800.));
+    r = VADD(VMUL(r,x2),VSET1(1./39916800.));
+    r = VADD(VMUL(r,x2),VSET1(-1./362880.));
+    r = VADD(VMUL(r,x2),VSET1(1./5040.));
+    r = VADD(VMUL(r,x2),VSET1(-1./120.));
+    r = VADD(VMUL(r,x2),VSET1(1./6.));
+    r = VSUB(VSET1(1.),VMUL(r,x2));
+    return VMUL(r,x);
+}
+
+static inline KATTR V KFN(vexp2)(V x) {
+    // 2^x for x in [-10,0]: 2^floor(x) built from the exponent bits, 2^fract(x) by Taylor series up to degree 13, error < 1e-13
+    V n = VFLOOR(x);
+    V f = VMUL(VSUB(x,n),VSET1(0.69314718055994530942));
+    V r = VSET1(1./6227020800.);
+    r = VADD(VMUL(r,f),VSET1(1./479001600.));
+    r = VADD(VMUL(r,f),VSET1(1./39916800.));
+    r = VADD(VMUL(r,f),VSET1(1./3628800.));
+    r = VADD(VMUL(r,f),VSET1(1./362880.));
+    r = VADD(VMUL(r,f),VSET1(1./40320.));
+    r = VADD(VMUL(r,f),VSET1(1./5040.));
+    r = VADD(VMUL(r,f),VSET1(1./720.));
+    r = VADD(VMUL(r,f),VSET1(1./120.));
+    r = VADD(VMUL(r,f),VSET1(1./24.));
+    r = VADD(VMUL(r,f),VSET1(1./6.));
+    r = VADD(VMUL(r,f),VSET1(1./2.));
+    r = VADD(VMUL(r,f),VSET1(1.));
+    r = VADD(VMUL(r,f),VSET1(1.));
+    return VMUL(r,VEXP2I(n));
+}
+
+static inline KATTR V KFN(vbounce)(V k) {
+    // BOUNCE_OUT, the four parabolas are selected from the last to the first
+    V s = VSET1(2.625/2.75), a = VSET1(0.984375);
+    V m;
+    m = VLT(k,VSET1(2.5/2.75));
+    s = VSEL(m,VSET1(2.25/2.75),s);
+    a = VSEL(m,VSET1(0.9375),a);
+    m = VLT(k,VSET1(2/2.75));
+    s = VSEL(m,VSET1(1.5/2.75),s);
+    a = VSEL(m,VSET1(0.75),a);
+    m = VLT(k,VSET1(1/2.75));
+    s = VSEL(m,VSET1(0.),s);
+    a = VSEL(m,VSET1(0.),a);
+    k = VSUB(k,s);
+    return VADD(VMUL(VSET1(7.5625),VMUL(k,k)),a);
+}
+
+static inline KATTR V KFN(vcalc)(V k, enum mode m) {
+    V one = VSET1(1.);
+    V half = VSET1(0.5);
+    V k2, s;
+
+    switch (m) {
+        case QUAD_IN:           return KFN(vpow)(k,2);
+        case QUAD_OUT:          return KFN(vpowout)(k,2);
+        case QUAD_INOUT:        return KFN(vpowinout)(k,2);
+        case CUBIC_IN:          return KFN(vpow)(k,3);
+        case CUBIC_OUT:         return KFN(vpowout)(k,3);
+        case CUBIC_INOUT:       return KFN(vpowinout)(k,3);
+        case QUARTIC_IN:        return KFN(vpow)(k,4);
+        case QUARTIC_OUT:       return KFN(vpowout)(k,4);
+        case QUARTIC_INOUT:     return KFN(vpowinout)(k,4);
+        case QUINTIC_IN:        return KFN(vpow)(k,5);
+        case QUINTIC_OUT:       return KFN(vpowout)(k,5);
+        case QUINTIC_INOUT:     return KFN(vpowinout)(k,5);
+
+        case SINUSOIDAL_IN:     // 1-cos(k*pi/2) = 1-sin((1-k)*pi/2)
+            return VSUB(one,KFN(vsin)(VMUL(VSUB(one,k),VSET1(M_PI/2))));
+        case SINUSOIDAL_OUT:
+            return KFN(vsin)(VMUL(k,VSET1(M_PI/2)));
+        case SINUSOIDAL_INOUT:  // -0.5*(cos(pi*k)-1) = 0.5-0.5*sin(pi*(0.5-k))
+            return VSUB(half,VMUL(half,KFN(vsin)(VMUL(VSUB(half,k),VSET1(M_PI)))));
+
+        case EXPONENTIAL_IN:
+            return KFN(vexp2)(VMUL(VSET1(10.),VSUB(k,one)));
+        case EXPONENTIAL_OUT:
+            return VSUB(one,KFN(vexp2)(VMUL(VSET1(-10.),k)));
+        case EXPONENTIAL_INOUT:
+            k2 = VADD(k,k);
+            s = VLT(k2,one);
+            k = KFN(vexp2)(VSEL(s,VMUL(VSET1(10.),VSUB(k2,one)),VMUL(VSET1(-10.),VSUB(k2,one))));
+            return VSEL(s,VMUL(half,k),VSUB(one,VMUL(half,k)));
+
+        case CIRCULAR_IN:
+            return VSUB(one,VSQRT(VSUB(one,VMUL(k,k))));
+        case CIRCULAR_OUT:
+            k = VSUB(k,one);
+            return VSQRT(VSUB(one,VMUL(k,k)));
+        case CIRCULAR_INOUT:
+            k2 = VADD(k,k);
+            s = VLT(k2,one);
+            k = VSEL(s,k2,VSUB(k2,VSET1(2.)));
+            k = VSQRT(VSUB(one,VMUL(k,k)));
+            return VSEL(s,VMUL(half,VSUB(one,k)),VMUL(half,VADD(k,one)));
+
+        case BACK_IN:
+            return VMUL(VMUL(k,k),VSUB(VMUL(VSET1(1.70158+1),k),VSET1(1.70158)));
+        case BACK_OUT:
+            k = VSUB(k,one);
+            return VADD(VMUL(VMUL(k,k),VADD(VMUL(VSET1(1.70158+1),k),VSET1(1.70158))),one);
+        case BACK_INOUT:
+            k2 = VADD(k,k);
+            s = VLT(k2,one);
+            k = VSEL(s,k2,VSUB(k2,VSET1(2.)));
+            k = VMUL(VMUL(half,VMUL(k,k)),VADD(VMUL(VSET1(1.70158*1.525+1),k),VSEL(s,VSET1(-1.70158*1.525),VSET1(1.70158*1.525))));
+            return VSEL(s,k,VADD(k,one));
+
+        case BOUNCE_IN:
+            return VSUB(one,KFN(vbounce)(VSUB(one,k)));
+        case BOUNCE_OUT:
+            return KFN(vbounce)(k);
+        case BOUNCE_INOUT:
+            k2 = VADD(k,k);
+            s = VLT(k,half);
+            k = KFN(vbounce)(VSEL(s,VSUB(one,k2),VSUB(k2,one)));
+            return VSEL(s,VMUL(half,VSUB(one,k)),VADD(VMUL(half,k),half));
+
+        case LINEAR:
+        default:
+            return k;
+    }
+}
+
+static KATTR void KFN(ramp_calc_block)(enum mode m, const double *k, double *e, long n) {
+    // one loop per mode so vcalc() is specialized, the elastic modes (sinusoid over several periods) are left to ramp_calc
+    long i = 0;
+
+    switch (m) {
+#define X(name)                                                     \
+        case name:                                                  \
+            if (name < ELASTIC_IN || name > ELASTIC_INOUT)          \
+                for (;i+VN<=n;i+=VN)                                \
+                    VSTORE(e+i,KFN(vcalc)(VLOAD(k+i),name));        \
+            break;
+        MODE_LIST
+#undef X
+        default:
+            break;
+    }
+    for (;i<n;i++)
+        e[i] = ramp_calc(k[i],m);
+}
@@ -0,0 +1,119 @@
+/**
+	ramp_lut.c - precomputed tables for the expensive interpolation modes
+
+	the sinusoidal, exponential, elastic and bounce modes are sampled once into a table
+	shared by every ramp using the same size, and linearly interpolated at runtime
+	the other modes are cheap polynomials or square roots and are always computed by ramp_calc_block()
+
+	maximum error against ramp_calc, measured over 100001 progressions:
+
+        size    sinusoidal  exponential elastic     bounce
+        16      2.4e-03     3.1e-02     1.0e-01     7.2e-02
+        64      1.5e-04     2.6e-03     9.8e-03     2.9e-02
+        256     9.4e-06     1.8e-04     7.1e-04     7.9e-03
+        1024    5.9e-07     1.1e-05     4.6e-05     1.9e-03
+        4096    3.7e-08     7.1e-07     2.9e-06     4.9e-04
+        16384   2.3e-09     4.5e-08     1.8e-07     6.5e-05
+        65536   1.4e-10     2.8e-09     1.1e-08     2.0e-05
+
+	the circular modes are left out: their slope is infinite at the ends of the ramp, where a uniform table
+	stays off by 1.1e-02 at 1024 intervals and only halves its error for each 4x increase of the size
+	the elements given a power, overshoot, amplitude or period are always computed by ramp_calc_shape()
+	the error is relative to the ramp amplitude: multiply by |destination-begin| to get it in output units
+ */
+
+#include <stdlib.h>
+
+#include "ramp_core.h"
+
+static t_ramp_lut *lut_cache[LUT_MAX_ORDER+1];     // one shared table per size, built on first request
+
+static void ramp_lut_free(t_ramp_lut *lut);
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+bool ramp_lut_mode(enum mode m) {
+    switch (m) {
+        case SINUSOIDAL_IN:
+        case SINUSOIDAL_OUT:
+        case SINUSOIDAL_INOUT:
+        case EXPONENTIAL_IN:
+        case EXPONENTIAL_OUT:
+        case EXPONENTIAL_INOUT:
+        case ELASTIC_IN:
+        case ELASTIC_OUT:
+        case ELASTIC_INOUT:
+        case BOUNCE_IN:
+        case BOUNCE_OUT:
+        case BOUNCE_INOUT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+long ramp_lut_size(long size) {
+    // round the requested size to a power of two in the supported range, 0 means no table
+    long order = LUT_MIN_ORDER;
+    if (size <= 0)
+        return 0;
+    while ((order < LUT_MAX_ORDER) && ((1L<<order) < size))
+        order++;
+    return 1L<<order;
+}
+
+const t_ramp_lut *ramp_lut_get(long size) {
+    long i, m, order = 0;
+
+    size = ramp_lut_size(size);
+    if (size == 0)
+        return NULL;
+    while ((1L<<order) < size)
+        order++;
+    if (lut_cache[order])
+        return lut_cache[order];
+
+    t_ramp_lut *lut = calloc(1,sizeof(t_ramp_lut));
+    if (!lut)
+        return NULL;
+    lut->size = size;
+    for (m=0;m<LAST;m++) {
+        if (!ramp_lut_mode(m))
+            continue;
+        lut->table[m] = malloc((size+1)*sizeof(double));
+        if (!lut->table[m]) {
+            ramp_lut_free(lut);
+            return NULL;
+        }
+        for (i=0;i<=size;i++)
+            lut->table[m][i] = ramp_calc(i/(double)size,m);
+    }
+    lut_cache[order] = lut;
+    return lut;
+}
+
+static void ramp_lut_free(t_ramp_lut *lut) {
+    long m;
+    for (m=0;m<LAST;m++)
+        free(lut->table[m]);
+    free(lut);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_lut_block(const t_ramp_lut *lut, enum mode m, const double *k, double *e, long n) {
+    // two loads and a lerp per element, k is clipped to 0..1
+    long i;
+    const double *t = lut->table[m];
+    double size = lut->size;
+
+    for (i=0;i<n;i++) {
+        double x = k[i]*size;
+        long j;
+        x = (x < 0) ? 0 : (x > size) ? size : x;
+        j = (long)x;
+        if (j == lut->size)
+            j--;
+        e[i] = t[j] + (t[j+1]-t[j])*(x-j);
+    }
+}
@@ -0,0 +1,121 @@
+/**
+	ramp_modes.c - interpolation mode names interned as symbols, for the Max objects built on ramp_core
+ */
+
+#include "ramp_modes.h"
+
+//--------------------------------------------------------------------------
+
+typedef struct _ramp_curves_box {
+    t_object c_ob;
+    t_ramp_curves *c_curves;    // user curves of the first binary loaded
+} t_ramp_curves_box;
+
+t_symbol *ramp_mode_sym[MODE_MAX];     // names of the interpolation modes then of the user curves, indexed by mode
+t_symbol *ramp_param_sym[PARAM_COUNT]; // names of the parameter messages, indexed by enum param
+
+void ramp_modes_init(void) {
+    // to be called once by ext_main, the first binary loaded publishes its user curves and the next ones use them
+    long i;
+    t_symbol *name = gensym("ramp_curves");
+    t_ramp_curves_box *box = (t_ramp_curves_box *)object_findregistered(CLASS_NOBOX, name);
+
+    if (box)
+        ramp_curves_share(box->c_curves);
+    else {
+        t_class *c = class_findbyname(CLASS_NOBOX, name);
+        if (!c) {
+            c = class_new("ramp_curves", NULL, NULL, sizeof(t_ramp_curves_box), 0L, 0);
+            class_register(CLASS_NOBOX, c);
+        }
+        box = (t_ramp_curves_box *)object_alloc(c);
+        if (box) {
+            box->c_curves = ramp_curves();
+            object_register(CLASS_NOBOX, name, box);
+        }
+    }
+    for (i=0;i<LAST;i++)
+        ramp_mode_sym[i] = gensym(mode_name[i]);
+    for (i=0;i<PARAM_COUNT;i++)
+        ramp_param_sym[i] = gensym(param_name[i]);
+}
+
+long ramp_mode_sym_find(t_symbol *s) {
+    // mode named by s, -1 if none
+    long i, n = ramp_mode_count();
+    for (i=0;i<n;i++) {
+        if (!ramp_mode_sym[i])
+            ramp_mode_sym[i] = gensym(ramp_mode_name(i));   // a curve defined by the other object
+        if (ramp_mode_sym[i] == s)
+            return i;
+    }
+    return -1;
+}
+
+long ramp_param_sym_find(t_symbol *s) {
+    // parameter named by s, -1 if none
+    long i;
+    for (i=0;i<PARAM_COUNT;i++) {
+        if (ramp_param_sym[i] == s)
+            return i;
+    }
+    return -1;
+}
+
+long ramp_curve_message(t_object *x, const char *object, long argc, t_atom *argv) {
+    // curve name bezier x1 y1 x2 y2, or curve name points x y x y..., returns the mode of the curve or -1
+    t_symbol *name, *kind;
+    long i, n, m = -1;
+
+    if (argc < 2 || atom_gettype(argv) != A_SYM || atom_gettype(argv+1) != A_SYM) {
+        object_error(x, "%s: curve needs a name and bezier or points", object);
+        return -1;
+    }
+    name = atom_getsym(argv);
+    kind = atom_getsym(argv+1);
+    if (ramp_mode_sym_find(name) >= 0 && ramp_mode_sym_find(name) < LAST) {
+        object_error(x, "%s: %s is a built-in mode", object, name->s_name);
+        return -1;
+    }
+    if (kind == gensym("bezier")) {
+        if (argc != 6) {
+            object_error(x, "%s: bezier needs x1 y1 x2 y2", object);
+            return -1;
+        }
+        m = ramp_curve_bezier(name->s_name, atom_getfloat(argv+2), atom_getfloat(argv+3), atom_getfloat(argv+4), atom_getfloat(argv+5));
+    }
+    else if (kind == gensym("points")) {
+        double *px, *py;
+        n = (argc-2)/2;
+        if (n < 1 || (argc-2)%2) {
+            object_error(x, "%s: points needs x y pairs", object);
+            return -1;
+        }
+        px = malloc(2*n*sizeof(double));
+        if (!px) {
+            object_error(x, "%s: out of memory", object);
+            return -1;
+        }
+        py = px+n;
+        for (i=0;i<n;i++) {
+            px[i] = atom_getfloat(argv+2+2*i);
+            py[i] = atom_getfloat(argv+3+2*i);
+        }
+        m = ramp_curve_points(name->s_name, px, py, n);
+        free(px);
+        if (m < 0) {
+            object_error(x, "%s: the points of %s must have growing x", object, name->s_name);
+            return -1;
+        }
+    }
+    else {
+        object_error(x, "%s: unknown curve type %s, use bezier or points", object, kind->s_name);
+        return -1;
+    }
+    if (m < 0) {
+        object_error(x, "%s: cannot define curve %s", object, name->s_name);
+        return -1;
+    }
+    ramp_mode_sym[m] = name;
+    return m;
+}
@@ -0,0 +1,25 @@
+/**
+	ramp_modes.h - interpolation mode names interned as symbols, for the Max objects built on ramp_core
+
+	gensym returns the same pointer for the same name, so once the names are interned
+	a mode is found by comparing pointers instead of strings
+	the user curves are interned when the curve message defines them or when a mode lookup first meets one defined by
+	the other object, the parameter messages with the modes
+	ramp and ramp~ are separate binaries: their user curves are shared through an object registered in the nobox namespace
+ */
+
+#ifndef RAMP_MODES_H
+#define RAMP_MODES_H
+
+#include "ext.h"
+#include "ramp_core.h"
+
+extern t_symbol *ramp_mode_sym[MODE_MAX];     // names of the interpolation modes then of the user curves, indexed by mode
+extern t_symbol *ramp_param_sym[PARAM_COUNT]; // names of the parameter messages, indexed by enum param
+
+void ramp_modes_init(void);
+long ramp_mode_sym_find(t_symbol *s);
+long ramp_param_sym_find(t_symbol *s);
+long ramp_curve_message(t_object *x, const char *object, long argc, t_atom *argv);
+
+#endif
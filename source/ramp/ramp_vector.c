@@ -0,0 +1,273 @@
+/**
+	ramp_vector.c - groups of elements moving together
+
+	a group is a run of consecutive elements (a position, a colour, a quaternion...) sharing the time, mode and progression
+	of its first element: the progression and the easing curve are computed once per group, in the block kernels of ramp_core_update(),
+	then the elements are interpolated together in the space of the group
+
+	the begin and destination are converted into that space once per ramp (on the first update after a restart) and cached,
+	so an update costs a few multiplications per element, plus two sines for a quaternion, the sRGB gamma for a colour
+	and a search in the arc length table for a spline
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "ramp_core.h"
+
+const char *vector_name[] = { "lerp", "slerp", "oklab", "spline" };
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_vector_free(t_ramp_group *g) {
+    free(g->via);
+    free(g->cache);
+    g->via = g->cache = NULL;
+    g->nvia = g->vsize = g->csize = 0;
+}
+
+static double *ramp_vector_cache(t_ramp_group *g, long n) {
+    // room for n cached values, NULL if out of memory
+    if (n > g->csize) {
+        double *tmp = realloc(g->cache, n*sizeof(double));
+        if (!tmp)
+            return NULL;
+        g->cache = tmp;
+        g->csize = n;
+    }
+    return g->cache;
+}
+
+static void ramp_vector_lerp(t_ramp_core *c, t_ramp_group *g, double e) {
+    long j;
+    for (j=g->first;j<g->first+g->dim;j++) {
+        c->act[j] = c->bgn[j] + (c->dst[j]-c->bgn[j])*e;
+        ramp_core_touch(c, j);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static bool slerp_start(t_ramp_core *c, t_ramp_group *g) {
+    // cache: the unit begin and destination, then their norms
+    long j, f = g->first;
+    double n0 = 0, n1 = 0, dot = 0;
+    double *q = ramp_vector_cache(g, 10);
+
+    if (!q)
+        return false;
+    for (j=0;j<4;j++) {
+        n0 += c->bgn[f+j]*c->bgn[f+j];
+        n1 += c->dst[f+j]*c->dst[f+j];
+        dot += c->bgn[f+j]*c->dst[f+j];
+    }
+    if (n0 == 0 || n1 == 0)
+        return false;                       // no rotation to follow
+    n0 = sqrt(n0);
+    n1 = sqrt(n1);
+    for (j=0;j<4;j++) {
+        q[j] = c->bgn[f+j]/n0;
+        q[4+j] = c->dst[f+j]/n1;
+    }
+    dot /= n0*n1;
+    if (dot < 0) {
+        // q and -q are the same rotation: the destination is flipped so the way is the shortest one,
+        // the ramp starts on the begin as sent and slerp gives back the destination as sent at the end
+        for (j=0;j<4;j++)
+            q[4+j] = -q[4+j];
+        dot = -dot;
+    }
+    q[8] = n0;                              // the norms are interpolated linearly
+    q[9] = n1;
+    g->theta = acos((dot > 1) ? 1 : dot);
+    return true;
+}
+
+static void slerp(t_ramp_core *c, t_ramp_group *g, double e) {
+    long j;
+    const double *q = g->cache;
+    double w0 = 1-e, w1 = e, n = q[8] + (q[9]-q[8])*e;
+    if (g->theta > 1e-6) {
+        double s = sin(g->theta);
+        w0 = sin((1-e)*g->theta)/s;
+        w1 = sin(e*g->theta)/s;
+    }
+    for (j=0;j<4;j++) {
+        c->act[g->first+j] = (e == 1) ? c->dst[g->first+j] : n*(w0*q[j] + w1*q[4+j]);
+        ramp_core_touch(c, g->first+j);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static double srgb_linear(double v) {
+    return (v <= 0.04045) ? v/12.92 : pow((v+0.055)/1.055, 2.4);
+}
+
+static double srgb_gamma(double v) {
+    return (v <= 0.0031308) ? 12.92*v : 1.055*pow(v, 1/2.4)-0.055;
+}
+
+static void oklab_from_rgb(const double *rgb, double *lab) {
+    // Björn Ottosson's OKLab, from linear sRGB
+    double r = srgb_linear(rgb[0]), g = srgb_linear(rgb[1]), b = srgb_linear(rgb[2]);
+    double l = cbrt(0.4122214708*r + 0.5363325363*g + 0.0514459929*b);
+    double m = cbrt(0.2119034982*r + 0.6806995451*g + 0.1073969566*b);
+    double s = cbrt(0.0883024619*r + 0.2817188376*g + 0.6299787005*b);
+    lab[0] = 0.2104542553*l + 0.7936177850*m - 0.0040720468*s;
+    lab[1] = 1.9779984951*l - 2.4285922050*m + 0.4505937099*s;
+    lab[2] = 0.0259040371*l + 0.7827717662*m - 0.8086757660*s;
+}
+
+static void oklab_to_rgb(const double *lab, double *rgb) {
+    double l = lab[0] + 0.3963377774*lab[1] + 0.2158037573*lab[2];
+    double m = lab[0] - 0.1055613458*lab[1] - 0.0638541728*lab[2];
+    double s = lab[0] - 0.0894841775*lab[1] - 1.2914855480*lab[2];
+    l = l*l*l;
+    m = m*m*m;
+    s = s*s*s;
+    rgb[0] = srgb_gamma( 4.0767416621*l - 3.3077115913*m + 0.2309699292*s);
+    rgb[1] = srgb_gamma(-1.2684380046*l + 2.6097574011*m - 0.3413193965*s);
+    rgb[2] = srgb_gamma(-0.0041960863*l - 0.7034186147*m + 1.7076147010*s);
+}
+
+static bool oklab_start(t_ramp_core *c, t_ramp_group *g) {
+    // cache: the begin and destination in OKLab, then the scale of each element (255 for the ints)
+    long j, f = g->first;
+    double rgb0[3], rgb1[3];
+    double *lab = ramp_vector_cache(g, 9);
+
+    if (!lab)
+        return false;
+    for (j=0;j<3;j++) {
+        lab[6+j] = (c->type[f+j] == TYPE_LONG) ? 255 : 1;
+        rgb0[j] = c->bgn[f+j]/lab[6+j];
+        rgb1[j] = c->dst[f+j]/lab[6+j];
+    }
+    oklab_from_rgb(rgb0, lab);
+    oklab_from_rgb(rgb1, lab+3);
+    return true;
+}
+
+static void oklab(t_ramp_core *c, t_ramp_group *g, double e) {
+    long j;
+    const double *lab = g->cache;
+    double mix[3], rgb[3];
+    for (j=0;j<3;j++)
+        mix[j] = lab[j] + (lab[3+j]-lab[j])*e;
+    oklab_to_rgb(mix, rgb);
+    for (j=0;j<3;j++) {
+        c->act[g->first+j] = rgb[j]*lab[6+j];
+        ramp_core_touch(c, g->first+j);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static void spline_point(const t_ramp_group *g, double t, double *p) {
+    // point of the uniform Catmull-Rom spline at t (span + fraction), the ends are extended by mirrored phantom points
+    long d, dim = g->dim, last = g->nvia+1;
+    long s = (t < 0) ? 0 : (t >= last) ? last-1 : (long)t;
+    double u = t-s;
+    const double *pts = g->cache;
+    const double *p1 = pts+s*dim, *p2 = pts+(s+1)*dim;
+    for (d=0;d<dim;d++) {
+        double a = (s > 0) ? p1[d-dim] : 2*p1[d]-p2[d];
+        double b = (s+1 < last) ? p2[d+dim] : 2*p2[d]-p1[d];
+        p[d] = 0.5*(2*p1[d] + (p2[d]-a)*u + (2*a-5*p1[d]+4*p2[d]-b)*u*u + (3*p1[d]-a-3*p2[d]+b)*u*u*u);
+    }
+}
+
+static bool spline_start(t_ramp_core *c, t_ramp_group *g) {
+    // cache: the begin, the via points and the destination, then the arc length at every sample
+    long i, d, dim = g->dim, npts = g->nvia+2, nsamp = (npts-1)*SPLINE_STEPS+1;
+    double *pts = ramp_vector_cache(g, npts*dim + nsamp + 2*dim);
+    double *arc, *prev, *p;
+
+    if (!pts)
+        return false;
+    for (d=0;d<dim;d++) {
+        pts[d] = c->bgn[g->first+d];
+        pts[(npts-1)*dim+d] = c->dst[g->first+d];
+    }
+    if (g->nvia > 0)
+        memcpy(pts+dim, g->via, g->nvia*dim*sizeof(double));
+    arc = pts+npts*dim;
+    prev = arc+nsamp;
+    p = prev+dim;
+    spline_point(g, 0, prev);
+    arc[0] = 0;
+    for (i=1;i<nsamp;i++) {
+        double l = 0;
+        spline_point(g, (double)i/SPLINE_STEPS, p);
+        for (d=0;d<dim;d++) {
+            l += (p[d]-prev[d])*(p[d]-prev[d]);
+            prev[d] = p[d];
+        }
+        arc[i] = arc[i-1]+sqrt(l);
+    }
+    g->length = arc[nsamp-1];
+    return true;
+}
+
+static void spline(t_ramp_core *c, t_ramp_group *g, double e) {
+    // the curve gives the distance along the spline, found in the arc length table then refined linearly within the sample
+    long d, dim = g->dim, npts = g->nvia+2, nsamp = (npts-1)*SPLINE_STEPS+1;
+    const double *arc = g->cache+npts*dim;
+    double *p = g->cache+npts*dim+nsamp+dim;
+    double l = e*g->length, t;
+    long lo = 0, hi = nsamp-1;
+
+    if (g->length <= 0)
+        t = e*(npts-1);
+    else {
+        if (l < arc[0])
+            hi = 1;                         // overshooting curves extend the first and last samples
+        else if (l >= arc[nsamp-1])
+            lo = nsamp-2;
+        else {
+            while (hi-lo > 1) {             // arc[lo] <= l < arc[hi]
+                long mid = (lo+hi)/2;
+                if (arc[mid] <= l) lo = mid;
+                else hi = mid;
+            }
+        }
+        t = (lo + ((arc[hi] > arc[lo]) ? (l-arc[lo])/(arc[hi]-arc[lo]) : 0))/SPLINE_STEPS;
+    }
+    spline_point(g, t, p);
+    for (d=0;d<dim;d++) {
+        c->act[g->first+d] = p[d];
+        ramp_core_touch(c, g->first+d);
+    }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_vector_calc(t_ramp_core *c, t_ramp_group *g, double e) {
+    // the elements of group g at the eased progression e, a group whose space cannot be set up moves as a lerp
+    bool ok = true;
+    if (g->fresh) {
+        switch (g->kind) {
+            case VECTOR_SLERP:  ok = slerp_start(c, g);     break;
+            case VECTOR_OKLAB:  ok = oklab_start(c, g);     break;
+            case VECTOR_SPLINE: ok = spline_start(c, g);    break;
+            default:                                        break;
+        }
+        g->fresh = false;
+        if (!ok)
+            g->theta = -1;                  // flag of the lerp fallback until the next restart
+        else if (g->kind != VECTOR_SLERP)
+            g->theta = 0;
+    }
+    if (g->theta < 0) {
+        ramp_vector_lerp(c, g, e);
+        return;
+    }
+    switch (g->kind) {
+        case VECTOR_SLERP:  slerp(c, g, e);             break;
+        case VECTOR_OKLAB:  oklab(c, g, e);             break;
+        case VECTOR_SPLINE: spline(c, g, e);            break;
+        default:            ramp_vector_lerp(c, g, e);  break;
+    }
+}
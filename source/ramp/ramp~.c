@@ -0,0 +1,416 @@
+/**
+	ramp~.c - non-linear interpolation object, signal version
+
+	this object has three inlets and one multichannel signal outlet
+	it responds to ints, floats and lists in the left inlet, times and modes like ramp
+	it responds to the 'assistance' message sent by Max when the mouse is positioned over an inlet or outlet
+    every element of a list is ramped on its own channel, computed sample by sample in the perform routine
+    with the same interpolation modes and block kernels as ramp (see ramp_core.h)
+ */
+
+#ifdef WIN_VERSION
+#define MAXAPI_USE_MSCRT
+#endif
+
+#include "ext.h"			// you must include this - it contains the external object's link to available Max functions
+#include "ext_obex.h"		// this is required for all objects using the newer style for writing objects.
+#include "z_dsp.h"			// required for MSP objects
+
+#include "ramp_core.h"      // Max independent interpolation engine
+#include "ramp_modes.h"     // mode names interned as symbols
+
+#define MAX_CHANS 1024
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+typedef struct _ramp_tilde {    // defines our object's internal variables for each instance in a patch
+    t_pxobject  r_ob;			// MSP object header - ALL MSP objects MUST begin with this...
+    long        r_in;           // store inlet number
+    long        r_chans;        // number of output channels, one per element of the list
+    double      r_step;         // duration of a sample (in ms)
+    t_ramp_core r_core;         // ramped values, length and reset settings
+    t_critical  r_lock;         // held while the core is changed, the messages and the perform routine both edit its active list, the perform routine only tries it
+    double      *r_hold;        // last output of each channel, repeated by a block which finds the core locked
+    void        *r_proxy;       // inlet proxy
+} t_ramp_tilde;
+
+void *ramp_tilde_new(t_symbol *s, long argc, t_atom *argv);
+void ramp_tilde_free(t_ramp_tilde *x);
+
+void ramp_tilde_int(t_ramp_tilde *x, long n);
+void ramp_tilde_float(t_ramp_tilde *x, double f);
+void ramp_tilde_list(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_tilde_set(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_tilde_time(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_tilde_mode(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_tilde_curve(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_tilde_shape(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv);
+void ramp_tilde_any(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv);
+
+void ramp_tilde_dsp64(t_ramp_tilde *x, t_object *dsp64, short *count, double samplerate, long maxvectorsize, long flags);
+void ramp_tilde_perform64(t_ramp_tilde *x, t_object *dsp64, double **ins, long numins, double **outs, long numouts, long sampleframes, long flags, void *userparam);
+long ramp_tilde_multichanneloutputs(t_ramp_tilde *x, long outletindex);
+
+void ramp_tilde_assist(t_ramp_tilde *x, void *b, long m, long a, char *s);
+t_max_err ramp_tilde_setchans(t_ramp_tilde *x, void *attr, long argc, t_atom *argv);
+
+
+t_class *ramp_tilde_class;		// global pointer to the object class - so max can reference the object
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ext_main(void *r) {
+
+    t_class *c;
+    c = class_new("ramp~", (method)ramp_tilde_new, (method)ramp_tilde_free, sizeof(t_ramp_tilde), 0L, A_GIMME, 0); // class_new() loads our external's class into Max's memory so it can be used in a patch
+
+	class_addmethod(c, (method)ramp_tilde_int,      "int",		A_LONG,     0);     // the method for an int in the left inlet                          (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_float,    "float",	A_FLOAT,    0);     // the method for a float in the left inlet                         (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_list,     "list",		A_GIMME,    0);     // the method for a list in the left inlet                          (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_time,     "time",		A_GIMME,    0);     // the method to set an int, a float or a list of times             (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_mode,     "mode",		A_GIMME,    0);     // the method to set an int, a symbol or a list of modes            (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_curve,    "curve",	A_GIMME,    0);     // define a mode: name bezier x1 y1 x2 y2 or name points x y...     (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_shape,    "power",	A_GIMME,    0);     // exponent of the quad to quintic modes, per channel               (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_shape,    "overshoot",A_GIMME,    0);     // overshoot of the back modes, per channel                         (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_shape,    "amplitude",A_GIMME,    0);     // amplitude of the elastic modes, per channel                      (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_shape,    "period",	A_GIMME,    0);     // period of the elastic modes, per channel                         (inlet 0)
+    class_addmethod(c, (method)ramp_tilde_any,      "anything", A_GIMME,    0);
+    
+    class_addmethod(c, (method)ramp_tilde_dsp64,    "dsp64",    A_CANT,     0);     // signal processing
+    class_addmethod(c, (method)ramp_tilde_multichanneloutputs, "multichanneloutputs", A_CANT, 0);     // number of channels of the outlet
+    class_addmethod(c, (method)ramp_tilde_assist,   "assist",	A_CANT,     0);     // (optional) assistance method needs to be declared like this
+    class_addmethod(c, (method)stdinletinfo,        "inletinfo",A_CANT,     0);     // (optional) get all left inlet cold
+
+    CLASS_ATTR_LONG(c, "chans", 0, t_ramp_tilde, r_chans);
+    CLASS_ATTR_ACCESSORS(c, "chans", NULL, ramp_tilde_setchans);
+    CLASS_ATTR_ORDER(c, "chans", 0, "1");
+    CLASS_ATTR_LABEL(c, "chans", 0, "Number of Output Channels");
+
+    CLASS_ATTR_CHAR(c, "reset_time", 0, t_ramp_tilde, r_core.reset_time);
+    CLASS_ATTR_ORDER(c, "reset_time", 0, "2");
+    CLASS_ATTR_STYLE_LABEL(c, "reset_time", 0, "onoff", "Reset time when finished");
+
+    ramp_modes_init();                      // intern the mode names, they are then found by pointer
+    ramp_kernel_select(-1);                 // use the best instruction set of this cpu for the easing kernels
+
+    class_dspinit(c);
+	class_register(CLASS_BOX, c);
+	ramp_tilde_class = c;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void *ramp_tilde_new(t_symbol *s, long argc, t_atom *argv) {
+    
+	t_ramp_tilde *x = (t_ramp_tilde *)object_alloc(ramp_tilde_class);     // create a new instance of this object
+    
+    long  time = 0;
+    long  mode = LINEAR;
+    long  found;
+    long  i;
+    
+    for (i=0;(i<argc)&&(i<2);i++) {
+        
+        /* arguments:
+            1. (long/sym) time or mode value
+            2. (long/sym) time or mode value
+         */
+        
+        switch (atom_gettype(argv+i)) {
+            case A_LONG:
+            case A_FLOAT:
+                time = atom_getlong(argv+i);
+                if (time < 0) time = 0;
+                break;
+                
+            case A_SYM:
+                if ((atom_getsym(argv+i)->s_name)[0]=='@')
+                    goto settings;
+                found = ramp_mode_sym_find(atom_getsym(argv+i));
+                if (found >= 0) {
+                    mode = found;
+                    break;
+                }
+
+            default:
+                error("ramp~: argument %ld must be interpolation mode or time value (0-inf)",i+1);
+                break;
+        }
+    }
+
+    settings:
+    dsp_setup((t_pxobject *)x, 0);          // no signal inlet, set up first so freeobject can release a partial object
+    critical_new(&x->r_lock);
+    x->r_chans = 1;                         // one channel by default
+    x->r_step = 1000./44100.;               // updated by the dsp64 method
+    x->r_hold = calloc(MAX_CHANS, sizeof(double));  // never reallocated, the perform routine reads it without the lock
+    if (!x->r_hold || !ramp_core_new(&x->r_core, time, mode, 1)) {
+        object_error((t_object *)x, "ramp~: out of memory");
+        freeobject(x);
+        return NULL;
+    }
+    
+    attr_args_process(x, argc, argv);       // process arguments
+
+    outlet_new(x, "multichannelsignal");    // one channel per element of the list
+
+    x->r_proxy = proxy_new((t_object *)x, 2, &x->r_in);          // create mode inlet
+    x->r_proxy = proxy_new((t_object *)x, 1, &x->r_in);          // create time inlet
+    
+	return(x);                              // return a reference to the object instance
+}
+
+void ramp_tilde_free(t_ramp_tilde *x) {
+    z_dsp_free((t_pxobject *)x);
+    ramp_core_free(&x->r_core);
+    free(x->r_hold);
+    critical_free(x->r_lock);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_tilde_assist(t_ramp_tilde *x, void *b, long m, long a, char *s) {
+    if (m == ASSIST_INLET) {
+        switch (a) {
+            case 0:
+                sprintf(s,"Destination Value of Ramp");
+                break;
+            case 1:
+                sprintf(s,"Total Ramp Time in Milliseconds");
+                break;
+            case 2:
+                sprintf(s,"Ramp Interpolation Mode");
+                break;
+        }
+    }
+    else
+        sprintf(s,"(multichannel signal) Ramp Output");
+}
+
+t_max_err ramp_tilde_setchans(t_ramp_tilde *x, void *attr, long argc, t_atom *argv) {
+    // the storage of the channels is reserved at once so a list is never cut, the outlet gets the new count when the dsp chain is compiled again
+    if (argc && argv) {
+        long n = atom_getlong(argv);
+        bool ok;
+        x->r_chans = (n<1) ? 1 : (n>MAX_CHANS) ? MAX_CHANS : n;
+        critical_enter(x->r_lock);
+        ok = ramp_core_reserve(&x->r_core, x->r_chans);
+        critical_exit(x->r_lock);
+        if (!ok)
+            object_error((t_object *)x, "ramp~: out of memory, %ld channels only", x->r_core.cap);
+    }
+    return MAX_ERR_NONE;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_tilde_int(t_ramp_tilde *x, long n) {
+    t_atom av;
+    atom_setlong(&av,n);
+    switch (proxy_getinlet((t_object *)x)) {
+        case 0:
+            ramp_tilde_set(x,NULL,1,&av);
+            break;
+        case 1:
+            ramp_tilde_time(x,NULL,1,&av);
+            break;
+        case 2:
+            ramp_tilde_mode(x,NULL,1,&av);
+            break;
+    }
+}
+
+void ramp_tilde_float(t_ramp_tilde *x, double f) {
+    t_atom av;
+    switch (proxy_getinlet((t_object *)x)) {
+        case 0:
+            atom_setfloat(&av,f);
+            ramp_tilde_set(x,NULL,1,&av);
+            break;
+        case 1:
+            atom_setlong(&av,f);
+            ramp_tilde_time(x,NULL,1,&av);
+            break;
+        case 2:
+            atom_setlong(&av,f);
+            ramp_tilde_mode(x,NULL,1,&av);
+            break;
+    }
+}
+
+void ramp_tilde_list(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv) {
+    switch (proxy_getinlet((t_object *)x)) {
+        case 0:
+            ramp_tilde_set(x,NULL,argc,argv);
+            break;
+        case 1:
+            ramp_tilde_time(x,NULL,argc,argv);
+            break;
+        case 2:
+            ramp_tilde_mode(x,NULL,argc,argv);
+            break;
+    }
+}
+
+void ramp_tilde_any(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv) {
+    if (ramp_mode_sym_find(s) >= 0)
+        ramp_tilde_mode(x,s,argc,argv);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ramp_tilde_set(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv) {
+    // new destinations, the elements beyond the number of channels are ignored so the perform routine never sees a reallocation
+    long i;
+    t_ramp_core *c = &x->r_core;
+    if (argc == 0)
+        return;
+    if (argc > x->r_chans)
+        argc = x->r_chans;
+    if (argc > c->cap) {
+        object_error((t_object *)x, "ramp~: out of memory, list truncated to %ld elements", c->cap);
+        argc = c->cap;
+    }
+    critical_enter(x->r_lock);
+    ramp_core_setlen(c, argc);
+    for (i=0;i<c->len;i++) {
+        switch (atom_gettype(argv+i)) {
+            case A_LONG:
+                ramp_core_set(c, i, atom_getfloat(argv+i), TYPE_LONG);
+                break;
+            case A_FLOAT:
+                ramp_core_set(c, i, atom_getfloat(argv+i), TYPE_FLOAT);
+                break;
+        }
+    }
+    critical_exit(x->r_lock);
+}
+
+void ramp_tilde_time(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv) {
+    long i;
+    double *pattern;
+    if (argc == 0)
+        return;
+    if (!(pattern = ramp_core_pattern(&x->r_core, PARAM_TIME, argc))) {
+        object_error((t_object *)x, "ramp~: out of memory");
+        return;
+    }
+    for (i=0;i<argc;i++) {
+        switch (atom_gettype(argv+i)) {
+            case A_LONG:
+            case A_FLOAT:
+                pattern[i] = atom_getlong(argv+i);
+                break;
+            default:
+                pattern[i] = PATTERN_SKIP;
+                break;
+        }
+    }
+    critical_enter(x->r_lock);
+    ramp_core_apply(&x->r_core, PARAM_TIME);
+    critical_exit(x->r_lock);
+}
+
+void ramp_tilde_curve(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv) {
+    // the new curve is a mode of every ramp~ object, used by its name like the built-in ones
+    ramp_curve_message((t_object *)x, "ramp~", argc, argv);
+}
+
+void ramp_tilde_shape(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv) {
+    // a list of curve parameters repeated over the channels, 0 is the default of the mode
+    long i;
+    double *pattern;
+    enum param p = ramp_param_sym_find(s);
+    if (p < PARAM_POWER || argc == 0)
+        return;
+    if (!(pattern = ramp_core_pattern(&x->r_core, p, argc))) {
+        object_error((t_object *)x, "ramp~: out of memory");
+        return;
+    }
+    for (i=0;i<argc;i++) {
+        switch (atom_gettype(argv+i)) {
+            case A_LONG:
+            case A_FLOAT:
+                pattern[i] = atom_getfloat(argv+i);
+                break;
+            default:
+                pattern[i] = PATTERN_SKIP;
+                break;
+        }
+    }
+    critical_enter(x->r_lock);
+    ramp_core_apply(&x->r_core, p);
+    critical_exit(x->r_lock);
+}
+
+void ramp_tilde_mode(t_ramp_tilde *x, t_symbol *s, long argc, t_atom *argv) {
+    long i, n, found;
+    double *pattern;
+
+    found = s ? ramp_mode_sym_find(s) : -1;     // the message selector can be a mode name
+    n = argc+(found>=0 ? 1 : 0);
+    if (n == 0)
+        return;
+    if (!(pattern = ramp_core_pattern(&x->r_core, PARAM_MODE, n))) {
+        object_error((t_object *)x, "ramp~: out of memory");
+        return;
+    }
+    if (found >= 0)
+        *pattern++ = found;
+    for (i=0;i<argc;i++) {
+        switch (atom_gettype(argv+i)) {
+            case A_LONG:
+            case A_FLOAT:
+                pattern[i] = atom_getlong(argv+i);
+                break;
+            case A_SYM:
+                found = ramp_mode_sym_find(atom_getsym(argv+i));
+                pattern[i] = (found >= 0) ? found : PATTERN_SKIP;
+                break;
+            default:
+                pattern[i] = PATTERN_SKIP;
+                break;
+        }
+    }
+    critical_enter(x->r_lock);
+    ramp_core_apply(&x->r_core, PARAM_MODE);
+    critical_exit(x->r_lock);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+long ramp_tilde_multichanneloutputs(t_ramp_tilde *x, long outletindex) {
+    return x->r_chans;
+}
+
+void ramp_tilde_dsp64(t_ramp_tilde *x, t_object *dsp64, short *count, double samplerate, long maxvectorsize, long flags) {
+    bool ok;
+    critical_enter(x->r_lock);
+    ok = ramp_core_reserve(&x->r_core, x->r_chans);
+    critical_exit(x->r_lock);
+    if (!ok) {
+        object_error((t_object *)x, "ramp~: out of memory");
+        return;
+    }
+    x->r_step = 1000./samplerate;
+    object_method(dsp64, gensym("dsp_add64"), x, ramp_tilde_perform64, 0, NULL);
+}
+
+void ramp_tilde_perform64(t_ramp_tilde *x, t_object *dsp64, double **ins, long numins, double **outs, long numouts, long sampleframes, long flags, void *userparam) {
+    // one element per channel, each block of samples goes through the easing kernel of its mode at once
+    // the audio thread never waits: while a message changes the core, the block repeats the last values and the ramps resume one block later
+    long i, j;
+    t_ramp_core *c = &x->r_core;
+    if (critical_tryenter(x->r_lock) != MAX_ERR_NONE) {
+        for (i=0;i<numouts;i++)
+            for (j=0;j<sampleframes;j++)
+                outs[i][j] = x->r_hold[i];
+        return;
+    }
+    for (i=0;i<numouts;i++) {
+        ramp_core_perform(c, i, x->r_step, outs[i], sampleframes);
+        if (sampleframes > 0)
+            x->r_hold[i] = outs[i][sampleframes-1];
+    }
+    critical_exit(x->r_lock);
+}
@@ -1,35 +1,72 @@
 /**
 	smoov.c - provide smoothing of data streams
 
-	this object has one inlet and one outlet
+	this object has one inlet and two outlets
 	it responds to ints, floats and 'bang' message in the left inlet
 	it responds to the 'assistance' message sent by Max when the mouse is positioned over an inlet or outlet
-	it smooths values by a factor choosen smooth value
-*/
-
-/** 
-    TODO-LIST
-    optimiser les accès mémoires en changeant de structure de données pour le stockage des listes : Index, AtomArray ???
+	it smooths values by a factor choosen smooth value, or with a time constant taking the time elapsed between the values into account,
+	or with a One Euro filter whose cutoff rises with the speed of the values, then can limit the slew rate and hold the output in a dead-band
+	with a rate, an internal clock outputs the filtered values at its own pace and can interpolate the values received at a slower one
 */
 
 #ifdef WIN_VERSION
 #define MAXAPI_USE_MSCRT
 #endif
 
-#define MAX_OBJECT 2048
+#define MIN_OBJECT 8         // elements allocated by a new smoov, the storage grows on demand
 
 #include "ext.h"			// you must include this - it contains the external object's link to available Max functions
 #include "ext_obex.h"		// this is required for all objects using the newer style for writing objects.
+#include <stdint.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+enum filter {FILTER_EXPONENTIAL, FILTER_EURO};
 
 typedef struct _smoov {         // defines our object's internal variables for each instance in a patch
     t_object    s_ob;			// object header - ALL objects MUST begin with this...
     long        s_len;          // length of the computed list
+    long        s_cap;          // number of allocated elements
     char        s_force_output; // force float output or not
     char        s_active;       // is the smoov filter active or not
+    char        s_sparse;       // output index value pairs of the filtered elements instead of the whole list
+    char        s_filter;       // filter of the values, enum filter
+    char        s_limited;      // the output went through the slew limit or the dead-band at the last filtering
+    char        s_delta;        // skip the outputs and the pairs which did not change by more than s_threshold
+    char        s_idle;         // the last filtering changed no output and every output has settled
+    char        s_interp;       // the clock interpolates between the received values
+    char        s_running;      // the clock is set
     double      s_smooth;		// float value - smoothing factor
-    t_atom*     s_value0;       // array of last received values
-    t_atom*     s_value1;       // array of previous received values
+    double      s_time;         // time constant (in ms), 0 to apply the smoothing factor to every value
+    double      s_dt;           // elapsed time of the cached coefficient (in ms)
+    double      s_coef;         // cached coefficient of the time constant over s_dt
+    double      s_mincutoff;    // One Euro cutoff frequency at rest (in Hz)
+    double      s_beta;         // One Euro cutoff increase per unit of speed
+    double      s_dcutoff;      // One Euro cutoff frequency of the speed (in Hz)
+    double      s_slew;         // largest change of the output per second, 0 for no limit
+    double      s_deadband;     // change of the filtered value the output ignores, 0 for no dead-band
+    double      s_threshold;    // largest change of an output value which is not a change
+    double      s_rate;         // time between the outputs of the clock (in ms), 0 to output each received value
+    double      s_tick;         // time of the last output of the clock, -1 before the first one
+    double*     s_input;        // array of last received values
+    double*     s_state;        // array of filtered values, kept as doubles and rounded at the output only
+    uint32_t*   s_type;         // bit i set when element i was received as an int
+    double*     s_stamp;        // time of the last filtering of each element, -1 before the first one
+    double*     s_speed;        // array of filtered speeds (per second) of the One Euro filter, allocated on first use
+    double*     s_output;       // array of outputs after the slew limit and the dead-band, allocated on first use
+    double*     s_last;         // array of the last output values, NaN when never output
+    long        s_last_len;     // length of the last full list output, -1 to force the next one
+    double*     s_from;         // array of the interpolated values when the last values were received, allocated on first use
+    double*     s_arrive;       // time the last value of each element was received, -1 before the first one
+    double*     s_span;         // interpolation time of each element (in ms), 0 to jump to the received value
+    double*     s_mix;          // array of the interpolated values fed to the filter by the clock
+    t_atom*     s_atoms;        // output buffer, the atoms are only built there
+    long        s_atoms_size;   // number of atoms allocated in the output buffer
     void*       s_outlet;       // outlet creation - inlets are automatic, but objects must "own" their own outlets
+    void*       s_outlet2;      // 1 when the outputs start changing, 0 when they stop
+    void*       s_clock;        // clock of the output rate
 } t_smoov;
 
 
@@ -38,11 +75,18 @@ void *smoov_new(t_symbol *s, long argc, t_atom *argv);
 void smoov_free(t_smoov *x);
 
 void smoov_bang(t_smoov *x);
+void smoov_tick(t_smoov *x);
 void smoov_int(t_smoov *x, long n);
 void smoov_float(t_smoov *x, double f);
 void smoov_list(t_smoov *x, t_symbol *s, long argc, t_atom *argv);
 void smoov_set(t_smoov *x, t_symbol *s, long argc, t_atom *argv);
+void smoov_lane(t_smoov *x, t_symbol *s, long argc, t_atom *argv);
+void smoov_lanes(t_smoov *x, t_symbol *s, long argc, t_atom *argv);
+bool smoov_reserve(t_smoov *x, long n);
 void smoov_assist(t_smoov *x, void *b, long m, long a, char *s);
+t_max_err smoov_settime(t_smoov *x, void *attr, long argc, t_atom *argv);
+t_max_err smoov_setfilter(t_smoov *x, void *attr, long argc, t_atom *argv);
+t_max_err smoov_setrate(t_smoov *x, void *attr, long argc, t_atom *argv);
 
 
 t_class *smoov_class;		// global pointer to the object class - so max can reference the object
@@ -60,6 +104,8 @@ void ext_main(void *r)
 	class_addmethod(c, (method)smoov_int,		"int",		A_LONG,     0);     // the method for an int in the left inlet                      (inlet 0)
     class_addmethod(c, (method)smoov_list,		"list",		A_GIMME,     0);    // the method for a list in the left inlet                      (inlet 0)
     class_addmethod(c, (method)smoov_float,		"float",	A_FLOAT,    0);     // the method for a float in the left inlet                     (inlet 0)
+    class_addmethod(c, (method)smoov_lane,		"lane",		A_GIMME,    0);     // filter one element: index value                              (inlet 0)
+    class_addmethod(c, (method)smoov_lanes,		"lanes",	A_GIMME,    0);     // filter consecutive elements: start value value...            (inlet 0)
 	class_addmethod(c, (method)smoov_assist,	"assist",	A_CANT,     0);     // (optional) assistance method needs to be declared like this
 
     CLASS_ATTR_CHAR(c, "active", 0, t_smoov, s_active);
@@ -70,12 +116,70 @@ void ext_main(void *r)
     CLASS_ATTR_LABEL(c, "smooth", 0, "Smoothing value");
     CLASS_ATTR_ORDER(c, "smooth", 0, "2");
     CLASS_ATTR_FILTER_CLIP(c, "smooth", 0., 1.);
+
+    CLASS_ATTR_DOUBLE(c, "time", 0, t_smoov, s_time);
+    CLASS_ATTR_ACCESSORS(c, "time", NULL, smoov_settime);
+    CLASS_ATTR_ORDER(c, "time", 0, "3");
+    CLASS_ATTR_LABEL(c, "time", 0, "Time constant in Milliseconds");
     
     CLASS_ATTR_CHAR(c, "force_output", 0, t_smoov, s_force_output);
-    CLASS_ATTR_ORDER(c, "force_output", 0, "3");
+    CLASS_ATTR_ORDER(c, "force_output", 0, "4");
     CLASS_ATTR_ENUMINDEX3(c, "force_output",0,"as input","int output","float output");
     CLASS_ATTR_LABEL(c, "force_output", 0, "Fore output style");
     
+    CLASS_ATTR_CHAR(c, "sparse", 0, t_smoov, s_sparse);
+    CLASS_ATTR_ORDER(c, "sparse", 0, "5");
+    CLASS_ATTR_STYLE_LABEL(c, "sparse", 0, "onoff", "Output index value pairs of the filtered elements");
+
+    CLASS_ATTR_CHAR(c, "filter", 0, t_smoov, s_filter);
+    CLASS_ATTR_ACCESSORS(c, "filter", NULL, smoov_setfilter);
+    CLASS_ATTR_ORDER(c, "filter", 0, "6");
+    CLASS_ATTR_ENUMINDEX2(c, "filter",0,"exponential","one euro");
+    CLASS_ATTR_LABEL(c, "filter", 0, "Filter");
+
+    CLASS_ATTR_DOUBLE(c, "mincutoff", 0, t_smoov, s_mincutoff);
+    CLASS_ATTR_ORDER(c, "mincutoff", 0, "7");
+    CLASS_ATTR_FILTER_MIN(c, "mincutoff", 0.);
+    CLASS_ATTR_LABEL(c, "mincutoff", 0, "One Euro cutoff at rest in Hz");
+
+    CLASS_ATTR_DOUBLE(c, "beta", 0, t_smoov, s_beta);
+    CLASS_ATTR_ORDER(c, "beta", 0, "8");
+    CLASS_ATTR_FILTER_MIN(c, "beta", 0.);
+    CLASS_ATTR_LABEL(c, "beta", 0, "One Euro speed coefficient");
+
+    CLASS_ATTR_DOUBLE(c, "dcutoff", 0, t_smoov, s_dcutoff);
+    CLASS_ATTR_ORDER(c, "dcutoff", 0, "9");
+    CLASS_ATTR_FILTER_MIN(c, "dcutoff", 0.);
+    CLASS_ATTR_LABEL(c, "dcutoff", 0, "One Euro speed cutoff in Hz");
+
+    CLASS_ATTR_DOUBLE(c, "slew", 0, t_smoov, s_slew);
+    CLASS_ATTR_ORDER(c, "slew", 0, "10");
+    CLASS_ATTR_FILTER_MIN(c, "slew", 0.);
+    CLASS_ATTR_LABEL(c, "slew", 0, "Largest change per second");
+
+    CLASS_ATTR_DOUBLE(c, "deadband", 0, t_smoov, s_deadband);
+    CLASS_ATTR_ORDER(c, "deadband", 0, "11");
+    CLASS_ATTR_FILTER_MIN(c, "deadband", 0.);
+    CLASS_ATTR_LABEL(c, "deadband", 0, "Dead-band width");
+
+    CLASS_ATTR_CHAR(c, "delta", 0, t_smoov, s_delta);
+    CLASS_ATTR_ORDER(c, "delta", 0, "12");
+    CLASS_ATTR_STYLE_LABEL(c, "delta", 0, "onoff", "Skip outputs equal to the last ones");
+
+    CLASS_ATTR_DOUBLE(c, "threshold", 0, t_smoov, s_threshold);
+    CLASS_ATTR_ORDER(c, "threshold", 0, "13");
+    CLASS_ATTR_FILTER_MIN(c, "threshold", 0.);
+    CLASS_ATTR_LABEL(c, "threshold", 0, "Largest change taken as equal");
+
+    CLASS_ATTR_DOUBLE(c, "rate", 0, t_smoov, s_rate);
+    CLASS_ATTR_ACCESSORS(c, "rate", NULL, smoov_setrate);
+    CLASS_ATTR_ORDER(c, "rate", 0, "14");
+    CLASS_ATTR_LABEL(c, "rate", 0, "Output rate in Milliseconds");
+
+    CLASS_ATTR_CHAR(c, "interp", 0, t_smoov, s_interp);
+    CLASS_ATTR_ORDER(c, "interp", 0, "15");
+    CLASS_ATTR_STYLE_LABEL(c, "interp", 0, "onoff", "Interpolate between the received values");
+    
 	class_register(CLASS_BOX, c);
 	smoov_class = c;
 }
@@ -89,7 +193,27 @@ void *smoov_new(t_symbol *s, long argc, t_atom *argv)	// n = float argument type
     x->s_len = 1;                           // set 1 by default
     x->s_active = 1;                        // set active by default
     x->s_force_output = 0;                  // set not active by default
+    x->s_sparse = 0;                        // set not active by default
     x->s_smooth = 0.1;                      // set the default value if no or bad argument
+    x->s_time = 0;                          // set not active by default
+    x->s_dt = -1;                           // no coefficient cached yet
+    x->s_coef = 1;
+    x->s_filter = FILTER_EXPONENTIAL;       // set the default value
+    x->s_limited = 0;
+    x->s_mincutoff = 1.;                    // set the default value
+    x->s_beta = 0.;                         // set the default value
+    x->s_dcutoff = 1.;                      // set the default value
+    x->s_slew = 0.;                         // set not active by default
+    x->s_deadband = 0.;                     // set not active by default
+    x->s_delta = 0;                         // set not active by default
+    x->s_idle = 1;                          // the first output is a start
+    x->s_threshold = 0.;                    // set the default value
+    x->s_rate = 0.;                         // set not active by default
+    x->s_interp = 0;                        // set not active by default
+    x->s_running = 0;
+    x->s_tick = -1;
+    x->s_clock = clock_new((t_object *)x, (method)smoov_tick);     // create a clock for the output rate
+    x->s_outlet2 = outlet_new(x, NULL);     // create a flexible outlet and assign it to our outlet variable in the instance's data structure
     x->s_outlet = outlet_new(x, NULL);      // create a flexible outlet and assign it to our outlet variable in the instance's data structure
     
     if (argc>0) {
@@ -109,24 +233,99 @@ void *smoov_new(t_symbol *s, long argc, t_atom *argv)	// n = float argument type
     
     attr_args_process(x, argc, argv);       // process arguments
     
-    t_atom *buffer0 = malloc(MAX_OBJECT*sizeof(t_atom));
-    t_atom *buffer1 = malloc(MAX_OBJECT*sizeof(t_atom));
-
-    x->s_value0 = buffer0;
-    x->s_value1 = buffer1;
-    
-    unsigned short i;
-    for (i=0;i<MAX_OBJECT;i++) {
-        atom_setlong(x->s_value0+i,0);     // set initial value in the instance's data structure
-        atom_setlong(x->s_value1+i,0);     // set initial value in the instance's data structure
-        }
+    x->s_input = NULL;
+    x->s_state = NULL;
+    x->s_type = NULL;
+    x->s_stamp = NULL;
+    x->s_speed = NULL;                      // allocated with the first One Euro filtering
+    x->s_output = NULL;                     // allocated with the first slew limit or dead-band
+    x->s_last = NULL;                       // allocated with the first output
+    x->s_last_len = -1;
+    x->s_from = NULL;                       // allocated with the first interpolation
+    x->s_arrive = NULL;
+    x->s_span = NULL;
+    x->s_mix = NULL;
+    x->s_atoms = NULL;                      // output buffer allocated with the first output
+    x->s_atoms_size = 0;
+    x->s_cap = 0;
+    if (!smoov_reserve(x, MIN_OBJECT)) {
+        object_error((t_object *)x, "smoov: out of memory");
+        freeobject(x);
+        return NULL;
+    }
     
 	return(x);                              // return a reference to the object instance
 }
 
 void smoov_free(t_smoov *x) {
-    free(x->s_value0);
-    free(x->s_value1);
+    if (x->s_clock)
+        freeobject(x->s_clock);
+    free(x->s_input);
+    free(x->s_state);
+    free(x->s_type);
+    free(x->s_stamp);
+    free(x->s_speed);
+    free(x->s_output);
+    free(x->s_last);
+    free(x->s_from);
+    free(x->s_arrive);
+    free(x->s_span);
+    free(x->s_mix);
+    free(x->s_atoms);
+}
+
+static bool smoov_grow(double **a, long cap, bool required)
+{
+    // reallocate an array of cap elements, the arrays allocated on first use are left alone until then
+    double *tmp;
+    if (!*a && !required)
+        return true;
+    tmp = realloc(*a, cap*sizeof(double));
+    if (!tmp) return false;
+    *a = tmp;
+    return true;
+}
+
+static void smoov_clear(t_smoov *x, long from, long to)
+{
+    // initial state of the elements from..to-1, of the allocated arrays
+    long i;
+    for (i=from;i<to;i++) {
+        x->s_input[i] = 0;                  // set initial value in the instance's data structure
+        x->s_state[i] = 0;                  // set initial value in the instance's data structure
+        x->s_stamp[i] = -1;                 // set initial value in the instance's data structure
+        if (x->s_speed) x->s_speed[i] = 0;
+        if (x->s_output) x->s_output[i] = 0;
+        if (x->s_last) x->s_last[i] = NAN;
+        if (x->s_from) x->s_from[i] = x->s_mix[i] = x->s_span[i] = 0;
+        if (x->s_arrive) x->s_arrive[i] = -1;
+        x->s_type[i>>5] |= (uint32_t)1<<(i&31);     // int until a float is received
+    }
+}
+
+bool smoov_reserve(t_smoov *x, long n) {
+    // make room for n elements, the capacity is doubled so a growing list is reallocated log(n) times
+    long cap = (x->s_cap < MIN_OBJECT) ? MIN_OBJECT : x->s_cap;
+    uint32_t *bits;
+    if (n <= x->s_cap)
+        return true;
+    while (cap < n)
+        cap *= 2;
+
+    if (!smoov_grow(&x->s_input, cap, true) || !smoov_grow(&x->s_state, cap, true) || !smoov_grow(&x->s_stamp, cap, true))
+        return false;
+    if (!smoov_grow(&x->s_speed, cap, false) || !smoov_grow(&x->s_output, cap, false) || !smoov_grow(&x->s_last, cap, false))
+        return false;
+    if (!smoov_grow(&x->s_from, cap, false) || !smoov_grow(&x->s_arrive, cap, false)
+        || !smoov_grow(&x->s_span, cap, false) || !smoov_grow(&x->s_mix, cap, false))
+        return false;
+    bits = realloc(x->s_type, ((cap+31)>>5)*sizeof(uint32_t));
+    if (!bits) return false;
+    x->s_type = bits;
+
+    smoov_clear(x, x->s_cap, cap);
+    x->s_cap = cap;
+    return true;
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -134,27 +333,389 @@ void smoov_free(t_smoov *x) {
 void smoov_assist(t_smoov *x, void *b, long m, long a, char *s) // 4 final arguments are always the same for the assistance method
 {
 	if (m == ASSIST_OUTLET)
-		sprintf(s,"Smoothed value");
+		sprintf(s,(a == 0) ? "Smoothed value" : "1 when the output starts changing, 0 when it stops");
 	else
         sprintf(s,"Inlet %ld: values and messages", a);
 }
 
 //---------------------------------------------------------------------------------------------------------------------------------------------------------
 
-void smoov_bang(t_smoov *x)
+static void smoov_blend(double *out, const double *in, long n, double a)
+{
+    // out = in*a + out*(1-a), the loop has no branch so the compiler can vectorize it
+    long i;
+    double b = 1.-a;
+    for (i=0;i<n;i++)
+        out[i] = in[i]*a + out[i]*b;
+}
+
+static double smoov_coef(t_smoov *x, double dt)
+{
+    // coefficient of the time constant over dt ms, cached so a steady input rate costs no exp
+    if (dt != x->s_dt) {
+        x->s_dt = dt;
+        x->s_coef = 1.-exp(-dt/x->s_time);
+    }
+    return x->s_coef;
+}
+
+static bool smoov_extra(t_smoov *x, double **a)
+{
+    // array of the adaptive filters, allocated on its first use so the plain filter does not pay for it
+    if (!*a) {
+        *a = calloc(x->s_cap, sizeof(double));
+        if (!*a) {
+            object_error((t_object *)x, "smoov: out of memory");
+            return false;
+        }
+    }
+    return true;
+}
+
+static void smoov_euro(t_smoov *x, const double *in, long i, long n, double dt)
+{
+    // One Euro filter of in over dt ms: the cutoff rises with the filtered speed, so slow moves are smoothed and fast ones follow without lag
+    long k;
+    double *out = x->s_state+i;
+    double *speed = x->s_speed+i;
+    double w = 2*M_PI*dt/1000.;             // the coefficient of a cutoff c is w*c/(1+w*c)
+    double ad = w*x->s_dcutoff/(1.+w*x->s_dcutoff);
+    double rate = 1000./dt;
+    double c0 = w*x->s_mincutoff, c1 = w*x->s_beta;
+    for (k=0;k<n;k++) {
+        double c;
+        speed[k] += ad*((in[i+k]-out[k])*rate - speed[k]);
+        c = c0 + c1*fabs(speed[k]);
+        out[k] += (in[i+k]-out[k])*c/(1.+c);
+    }
+}
+
+static void smoov_limit(t_smoov *x, long i, long n, double dt)
+{
+    // the output ignores the changes of the filtered value within the dead-band, then moves by slew*dt at most
+    long k;
+    const double *in = x->s_state+i;
+    double *out = x->s_output+i;
+    double d = (dt < 0) ? 0. : x->s_deadband;                              // the first value is taken as it is
+    double r = (x->s_slew > 0 && dt >= 0) ? x->s_slew*dt/1000. : HUGE_VAL;
+    for (k=0;k<n;k++) {
+        double lo = in[k]-d, hi = in[k]+d;
+        double t = (out[k] < lo) ? lo : out[k];             // one comparison per line so the selects vectorize
+        double step;
+        t = (t > hi) ? hi : t;
+        step = t-out[k];
+        step = (step < -r) ? -r : step;
+        out[k] += (step > r) ? r : step;
+    }
+}
+
+static void smoov_run(t_smoov *x, const double *in, long i, long n, double dt)
+{
+    // filter the elements i..i+n-1 of in, filtered dt ms ago, -1 for their first value which is taken as it is
+    if (!x->s_active)
+        smoov_blend(x->s_state+i, in+i, n, 1.);
+    else if (x->s_filter == FILTER_EURO && x->s_speed) {
+        // a value received with no time elapsed changes nothing
+        if (dt < 0) {
+            smoov_blend(x->s_state+i, in+i, n, 1.);
+            memset(x->s_speed+i, 0, n*sizeof(double));
+        }
+        else if (dt > 0)
+            smoov_euro(x, in, i, n, dt);
+    }
+    else if (x->s_time > 0)
+        smoov_blend(x->s_state+i, in+i, n, (dt < 0) ? 1. : smoov_coef(x, dt));
+    else
+        smoov_blend(x->s_state+i, in+i, n, x->s_smooth);
+    if (x->s_limited)
+        smoov_limit(x, i, n, dt);
+}
+
+static void smoov_filter(t_smoov *x, const double *in, long start, long n)
+{
+    // filter the elements start..start+n-1 of in, the received values or the interpolated ones, the elements filtered together last time share one elapsed time, a whole list is one pass
+    long i, j, end = start+n;
+    double now;
+    bool limit = x->s_active && (x->s_slew > 0 || x->s_deadband > 0) && smoov_extra(x, &x->s_output);
+    clock_getftime(&now);
+    if (x->s_active && x->s_filter == FILTER_EURO)
+        smoov_extra(x, &x->s_speed);
+    if (limit && !x->s_limited)
+        memcpy(x->s_output, x->s_state, x->s_len*sizeof(double));      // the limited output starts from the filtered values
+    x->s_limited = limit;
+    if (!limit && (!x->s_active || (x->s_filter == FILTER_EXPONENTIAL && x->s_time <= 0))) {
+        smoov_run(x, in, start, n, 0);      // the elapsed time is not used
+    }
+    else {
+        for (i=start;i<end;i=j) {
+            double t = x->s_stamp[i];
+            for (j=i+1;j<end&&x->s_stamp[j]==t;j++);
+            smoov_run(x, in, i, j-i, (t < 0) ? -1 : now-t);
+        }
+    }
+    for (i=start;i<end;i++)
+        x->s_stamp[i] = now;                // kept in every mode, so switching to a time constant goes on smoothly
+}
+
+static void smoov_store(t_smoov *x, long i, const t_atom *a)
+{
+    // new value of element i, its type is kept in the bitmap for the output
+    uint32_t bit = (uint32_t)1<<(i&31);
+    switch (atom_gettype(a)) {
+        case A_FLOAT:
+            x->s_input[i] = atom_getfloat(a);
+            x->s_type[i>>5] &= ~bit;
+            break;
+        case A_LONG:
+            x->s_input[i] = atom_getlong(a);
+            x->s_type[i>>5] |= bit;
+            break;
+        default:
+            x->s_input[i] = 0;
+            x->s_type[i>>5] |= bit;
+            break;
+    }
+}
+
+static double smoov_value(t_smoov *x, long i, bool *isint)
+{
+    // output value of element i, rounded when it is output as an int
+    double v = (x->s_limited) ? x->s_output[i] : x->s_state[i];
+    *isint = (x->s_force_output == 0) ? (x->s_type[i>>5]>>(i&31))&1 : (x->s_force_output == 1);
+    return (*isint) ? round(v) : v;
+}
+
+static void smoov_setatom(t_atom *a, double v, bool isint)
+{
+    // get float or int value output depending on input and attribute settings
+    if (isint) atom_setlong(a,(t_atom_long)v);
+    else atom_setfloat(a,v);
+}
+
+static t_atom *smoov_atoms(t_smoov *x, long n)
+{
+    // output buffer of at least n atoms, it only grows so outputs do not allocate
+    if (n > x->s_atoms_size) {
+        t_atom *tmp = realloc(x->s_atoms, n*sizeof(t_atom));
+        if (!tmp) {
+            object_error((t_object *)x, "smoov: out of memory");
+            return NULL;
+        }
+        x->s_atoms = tmp;
+        x->s_atoms_size = n;
+    }
+    return x->s_atoms;
+}
+
+static double *smoov_last(t_smoov *x)
+{
+    // last output values of the idle and active states and of the delta mode, allocated with the first output
+    if (!x->s_last) {
+        long i;
+        x->s_last = malloc(x->s_cap*sizeof(double));
+        if (!x->s_last) {
+            object_error((t_object *)x, "smoov: out of memory");
+            return NULL;
+        }
+        for (i=0;i<x->s_cap;i++)
+            x->s_last[i] = NAN;             // never output, so always a change
+    }
+    return x->s_last;
+}
+
+static bool smoov_same(t_smoov *x, double v, double last)
+{
+    // a change of at most s_threshold is no change, NaN (never output) always is one
+    return fabs(v-last) <= x->s_threshold;
+}
+
+static bool smoov_settled(t_smoov *x)
 {
-    unsigned int i;
+    // every output is within the threshold of its input, or of the dead-band around it, so the next values will not change it
+    long i;
+    bool isint;
+    double tolerance = x->s_threshold + ((x->s_limited) ? x->s_deadband : 0);
     for (i=0;i<x->s_len;i++) {
-        if ((((x->s_value0+i)->a_type == A_LONG) &&(x->s_force_output==0))||(x->s_force_output==1)) {
-            double val = (x->s_active) ? atom_getfloat(x->s_value0+i)*x->s_smooth + atom_getfloat(x->s_value1+i)*(1.-x->s_smooth) : atom_getfloat(x->s_value0+i);
-            atom_setlong(x->s_value1+i,round(val));
+        double v = smoov_value(x,i,&isint);
+        double target = (isint) ? round(x->s_input[i]) : x->s_input[i];
+        if (!(fabs(v-target) <= tolerance))
+            return false;
+    }
+    return true;
+}
+
+static void smoov_status(t_smoov *x, bool changed)
+{
+    // notify when the outputs start changing or become idle, before the output as outlets fire from right to left
+    // idle means no output changed and every element has settled, so an int output held by its rounding for a while is not idle
+    bool active = changed || !smoov_settled(x);
+    if (active == x->s_idle) {
+        x->s_idle = !active;
+        outlet_int(x->s_outlet2, active);
+    }
+}
+
+static void smoov_output(t_smoov *x, long start, long n)
+{
+    // output the elements start..start+n-1, as index value pairs in sparse mode or as the whole list
+    // the last values are kept in every mode for the idle and active states, in delta mode the list is skipped when no value changed
+    // and the pairs of the unchanged values are skipped
+    long i, m, moved;
+    bool isint;
+    double v, *last = smoov_last(x);        // NULL when out of memory, the values are then output without the states
+    t_atom *out;
+    bool skip = x->s_delta && last;
+    if (!x->s_sparse) {
+        bool changed = !last || (x->s_len != x->s_last_len);
+        for (i=0;i<x->s_len&&!changed;i++)
+            changed = !smoov_same(x, smoov_value(x,i,&isint), last[i]);
+        if (last)
+            smoov_status(x, changed);
+        if (skip && !changed)
+            return;                         // the atoms are not even built
+        if (!(out = smoov_atoms(x, x->s_len)))
+            return;
+        for (i=0;i<x->s_len;i++) {
+            v = smoov_value(x,i,&isint);
+            smoov_setatom(out+i,v,isint);
+            if (last) last[i] = v;          // the whole list is kept as the last values, the sparse mode can take over
         }
-        if ((((x->s_value0+i)->a_type == A_FLOAT)&&(x->s_force_output==0))||(x->s_force_output==2)) {
-            double val = (x->s_active) ? atom_getfloat(x->s_value0+i)*x->s_smooth + atom_getfloat(x->s_value1+i)*(1.-x->s_smooth) : atom_getfloat(x->s_value0+i);
-            atom_setfloat(x->s_value1+i,val);
+        x->s_last_len = x->s_len;
+        outlet_list(x->s_outlet, NULL, x->s_len, out);
+        return;
+    }
+    if (!(out = smoov_atoms(x, 2*n)))
+        return;
+    for (i=0,m=0,moved=0;i<n;i++) {
+        bool changed = true;
+        v = smoov_value(x,start+i,&isint);
+        if (last) {
+            changed = !smoov_same(x, v, last[start+i]);
+            if (changed) last[start+i] = v;
         }
+        moved += changed;
+        if (skip && !changed) continue;
+        atom_setlong(out+m,start+i);
+        smoov_setatom(out+m+1,v,isint);
+        m += 2;
     }
-    outlet_list(x->s_outlet, NULL, x->s_len,x->s_value1);
+    if (last)
+        smoov_status(x, moved > 0);
+    if (m) outlet_list(x->s_outlet, NULL, m, out);
+}
+
+static bool smoov_interp(t_smoov *x)
+{
+    // arrays of the interpolation, allocated with the first one, every element jumps to its first received value
+    long i;
+    if (x->s_from)
+        return true;
+    x->s_from = calloc(x->s_cap, sizeof(double));
+    x->s_arrive = malloc(x->s_cap*sizeof(double));
+    x->s_span = calloc(x->s_cap, sizeof(double));
+    x->s_mix = calloc(x->s_cap, sizeof(double));
+    if (!x->s_from || !x->s_arrive || !x->s_span || !x->s_mix) {
+        free(x->s_from); free(x->s_arrive); free(x->s_span); free(x->s_mix);
+        x->s_from = x->s_arrive = x->s_span = x->s_mix = NULL;
+        object_error((t_object *)x, "smoov: out of memory");
+        return false;
+    }
+    for (i=0;i<x->s_cap;i++)
+        x->s_arrive[i] = -1;
+    return true;
+}
+
+static void smoov_mix(t_smoov *x, long start, long n, double now)
+{
+    // values interpolated at now, from the value at the last reception to the received one over the span
+    long k;
+    const double *in = x->s_input+start, *from = x->s_from+start, *arrive = x->s_arrive+start, *span = x->s_span+start;
+    double *mix = x->s_mix+start;
+    for (k=0;k<n;k++) {
+        double jump = (span[k] <= 0);                       // no span, the value is reached at once, no select so the loop vectorizes
+        double t = (now-arrive[k])/(span[k]+jump) + jump;
+        t = (t > 1.) ? 1. : t;
+        mix[k] = from[k] + (in[k]-from[k])*t;
+    }
+}
+
+static void smoov_arrive(t_smoov *x, long start, long n)
+{
+    // values about to be received by the elements start..start+n-1, the interpolation goes on from where it is now
+    // to the new value over the time elapsed since the last one, a pause longer than twice the last span keeps that span
+    long i;
+    double now;
+    if (x->s_rate <= 0 || !x->s_interp || !smoov_interp(x))
+        return;
+    clock_getftime(&now);
+    smoov_mix(x, start, n, now);
+    for (i=start;i<start+n;i++) {
+        double gap = now - x->s_arrive[i];
+        double span = x->s_span[i];
+        x->s_from[i] = x->s_mix[i];
+        if (x->s_arrive[i] < 0)
+            x->s_span[i] = 0;               // the first value is taken as it is
+        else if (gap > 0 && (span <= 0 || gap <= 2*span))
+            x->s_span[i] = gap;             // several values at once keep the span of the first one
+        x->s_arrive[i] = now;
+    }
+}
+
+static bool smoov_timed(t_smoov *x)
+{
+    // the filter moves on with time alone, so the clock advances it between the received values
+    return x->s_active && (x->s_filter == FILTER_EURO || x->s_time > 0 || x->s_slew > 0);
+}
+
+static void smoov_input(t_smoov *x, long start, long n)
+{
+    // values received by the elements start..start+n-1: filtered and output at once, or left to the clock
+    if (x->s_rate <= 0) {
+        smoov_filter(x,x->s_input,start,n);
+        smoov_output(x,start,n);
+        return;
+    }
+    if (!x->s_interp)
+        smoov_filter(x,x->s_input,start,n);     // each value is filtered, the clock outputs the last state
+    if (!x->s_running) {
+        double now, wait;
+        clock_getftime(&now);
+        wait = (x->s_tick < 0) ? 0 : x->s_tick + x->s_rate - now;     // a value after a rest is output at once, within the rate
+        x->s_running = 1;
+        clock_fdelay(x->s_clock, (wait < 0) ? 0 : wait);
+    }
+}
+
+void smoov_tick(t_smoov *x)
+{
+    // clock of the output rate: filter towards the interpolated values, or advance the filter towards the last ones, and output the whole list
+    // the clock sleeps when nothing moves until the next received value, or once the output is idle in delta mode, the next value wakes it up
+    double now;
+    bool moving = x->s_interp || smoov_timed(x);
+    x->s_running = 0;
+    if (x->s_rate <= 0)
+        return;
+    clock_getftime(&now);
+    x->s_tick = now;
+    if (x->s_interp && smoov_interp(x)) {
+        smoov_mix(x, 0, x->s_len, now);
+        smoov_filter(x,x->s_mix,0,x->s_len);
+    }
+    else if (smoov_timed(x))
+        smoov_filter(x,x->s_input,0,x->s_len);
+    smoov_output(x,0,x->s_len);
+    if (moving && !(x->s_delta && x->s_idle)) {
+        x->s_running = 1;
+        clock_fdelay(x->s_clock, x->s_rate);
+    }
+}
+
+void smoov_bang(t_smoov *x)
+{
+    // filter again and output, with a rate the clock filters so only the current values are output
+    if (x->s_rate <= 0)
+        smoov_filter(x,x->s_input,0,x->s_len);
+    smoov_output(x,0,x->s_len);
 }
 
 
@@ -163,7 +724,7 @@ void smoov_int(t_smoov *x, long n)
     t_atom av;
     atom_setlong(&av,n);
     smoov_set(x,NULL,1,&av);
-	smoov_bang(x);
+	smoov_input(x,0,x->s_len);
 }
 
 void smoov_float(t_smoov *x, double f)
@@ -171,29 +732,112 @@ void smoov_float(t_smoov *x, double f)
     t_atom av;
     atom_setfloat(&av,f);
     smoov_set(x,NULL,1,&av);
-    smoov_bang(x);
+    smoov_input(x,0,x->s_len);
 }
 
 void smoov_list(t_smoov *x, t_symbol *s, long argc, t_atom *argv)
 {
     smoov_set(x,NULL,argc,argv);
-    smoov_bang(x);
+    smoov_input(x,0,x->s_len);
 }
 
 
 void smoov_set(t_smoov *x, t_symbol *s, long argc, t_atom *argv)
 {
-    unsigned int i;
-    x->s_len = (argc>MAX_OBJECT) ? MAX_OBJECT : argc;
-    for (i=0;i<x->s_len;i++) {
-        switch (atom_gettype(argv+i)) {
-            case A_LONG:
-            case A_FLOAT:
-                *(x->s_value0+i) = *(argv+i);
-                break;
-            default:
-                atom_setlong(x->s_value0+i,0    );
-                break;
+    long i;
+    if (!smoov_reserve(x, argc))
+        object_error((t_object *)x, "smoov: out of memory, list truncated to %ld elements", x->s_cap);
+    x->s_len = (argc>x->s_cap) ? x->s_cap : argc;
+    smoov_arrive(x,0,x->s_len);
+    for (i=0;i<x->s_len;i++)
+        smoov_store(x,i,argv+i);
+}
+
+static bool smoov_index(t_smoov *x, t_atom *a, long n, long *index)
+{
+    // element index of a lane message, the list grows up to index+n elements
+    long i = atom_getlong(a);
+    if ((atom_gettype(a) != A_LONG && atom_gettype(a) != A_FLOAT) || i < 0 || (atom_gettype(a) == A_FLOAT && atom_getfloat(a) != i)) {
+        object_error((t_object *)x, "smoov: lane index must be a non-negative int");
+        return false;
+    }
+    if (!smoov_reserve(x, i+n)) {
+        object_error((t_object *)x, "smoov: out of memory, list truncated to %ld elements", x->s_cap);
+        if (i >= x->s_cap) return false;
+    }
+    if (i+n > x->s_len) {
+        long len = (i+n>x->s_cap) ? x->s_cap : i+n;
+        smoov_clear(x, x->s_len, len);      // the elements added to the list start from 0
+        x->s_len = len;
+    }
+    *index = i;
+    return true;
+}
+
+void smoov_lane(t_smoov *x, t_symbol *s, long argc, t_atom *argv)
+{
+    // lane index value, only this element is filtered
+    long i;
+    if (argc < 2 || (atom_gettype(argv+1) != A_LONG && atom_gettype(argv+1) != A_FLOAT)) {
+        object_error((t_object *)x, "smoov: lane needs an index and a value");
+        return;
+    }
+    if (!smoov_index(x, argv, 1, &i))
+        return;
+    smoov_arrive(x,i,1);
+    smoov_store(x,i,argv+1);
+    smoov_input(x,i,1);
+}
+
+void smoov_lanes(t_smoov *x, t_symbol *s, long argc, t_atom *argv)
+{
+    // lanes start value value..., only the consecutive elements from start are filtered
+    long i, j, n;
+    if (argc < 2) {
+        object_error((t_object *)x, "smoov: lanes needs a start index and values");
+        return;
+    }
+    if (!smoov_index(x, argv, argc-1, &i))
+        return;
+    n = (i+argc-1>x->s_len) ? x->s_len-i : argc-1;
+    smoov_arrive(x,i,n);
+    for (j=0;j<n;j++)
+        smoov_store(x,i+j,argv+1+j);
+    smoov_input(x,i,n);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+t_max_err smoov_settime(t_smoov *x, void *attr, long argc, t_atom *argv)
+{
+    if (argc && argv) {
+        double t = atom_getfloat(argv);
+        x->s_time = (t<0.) ? 0. : t;
+        x->s_dt = -1;                       // the cached coefficient belongs to the former time constant
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err smoov_setfilter(t_smoov *x, void *attr, long argc, t_atom *argv)
+{
+    if (argc && argv) {
+        long f = atom_getlong(argv);
+        x->s_filter = (f == FILTER_EURO) ? FILTER_EURO : FILTER_EXPONENTIAL;
+        if (x->s_speed)
+            memset(x->s_speed, 0, x->s_cap*sizeof(double));     // the One Euro filter starts at rest
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err smoov_setrate(t_smoov *x, void *attr, long argc, t_atom *argv)
+{
+    if (argc && argv) {
+        double r = atom_getfloat(argv);
+        x->s_rate = (r<0.) ? 0. : r;
+        if (x->s_rate <= 0 && x->s_running) {   // back to an output for each received value
+            clock_unset(x->s_clock);
+            x->s_running = 0;
         }
     }
-}
\ No newline at end of file
+    return MAX_ERR_NONE;
+}
@@ -0,0 +1,233 @@
+/**
+	smoov~.c - provide smoothing of signals
+
+	this object has one multichannel signal inlet and one multichannel signal outlet
+	it runs the smoov filter sample by sample: output = output + coef*(input - output)
+	the coefficient comes from a time constant in milliseconds or a cutoff frequency in Hz,
+	so the response does not depend on the sample rate or on the rate of the incoming values
+*/
+
+#ifdef WIN_VERSION
+#define MAXAPI_USE_MSCRT
+#endif
+
+#include "ext.h"			// you must include this - it contains the external object's link to available Max functions
+#include "ext_obex.h"		// this is required for all objects using the newer style for writing objects.
+#include "z_dsp.h"			// required for MSP objects
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+
+typedef struct _smoov_tilde {   // defines our object's internal variables for each instance in a patch
+    t_pxobject  s_ob;			// MSP object header - ALL MSP objects MUST begin with this...
+    char        s_active;       // is the smoov filter active or not
+    double      s_time;         // time constant (in ms)
+    double      s_freq;         // cutoff frequency (in Hz), same setting as s_time
+    double      s_step;         // duration of a sample (in ms)
+    double      s_coef;         // filter coefficient for one sample
+    long        s_chans;        // number of channels of the input, and of the output
+    long        s_cap;          // number of allocated states
+    double*     s_state;        // last output of each channel
+} t_smoov_tilde;
+
+
+// these are prototypes for the methods that are defined below
+void *smoov_tilde_new(t_symbol *s, long argc, t_atom *argv);
+void smoov_tilde_free(t_smoov_tilde *x);
+
+void smoov_tilde_clear(t_smoov_tilde *x);
+void smoov_tilde_dsp64(t_smoov_tilde *x, t_object *dsp64, short *count, double samplerate, long maxvectorsize, long flags);
+void smoov_tilde_perform64(t_smoov_tilde *x, t_object *dsp64, double **ins, long numins, double **outs, long numouts, long sampleframes, long flags, void *userparam);
+long smoov_tilde_inputchanged(t_smoov_tilde *x, long index, long count);
+long smoov_tilde_multichanneloutputs(t_smoov_tilde *x, long index);
+void smoov_tilde_assist(t_smoov_tilde *x, void *b, long m, long a, char *s);
+
+t_max_err smoov_tilde_settime(t_smoov_tilde *x, void *attr, long argc, t_atom *argv);
+t_max_err smoov_tilde_setfreq(t_smoov_tilde *x, void *attr, long argc, t_atom *argv);
+
+
+t_class *smoov_tilde_class;		// global pointer to the object class - so max can reference the object
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void ext_main(void *r)
+{
+	t_class *c;
+
+	c = class_new("smoov~", (method)smoov_tilde_new, (method)smoov_tilde_free, sizeof(t_smoov_tilde), 0L, A_GIMME, 0); // class_new() loads our external's class into Max's memory so it can be used in a patch
+
+    class_addmethod(c, (method)smoov_tilde_clear,       "clear",                0);             // reset the filter states to 0
+    class_addmethod(c, (method)smoov_tilde_dsp64,       "dsp64",                A_CANT, 0);     // signal processing
+    class_addmethod(c, (method)smoov_tilde_inputchanged,"inputchanged",         A_CANT, 0);     // number of channels of the inlet
+    class_addmethod(c, (method)smoov_tilde_multichanneloutputs, "multichanneloutputs", A_CANT, 0);     // same number of channels for the outlet
+	class_addmethod(c, (method)smoov_tilde_assist,      "assist",               A_CANT, 0);     // (optional) assistance method needs to be declared like this
+
+    CLASS_ATTR_CHAR(c, "active", 0, t_smoov_tilde, s_active);
+    CLASS_ATTR_ORDER(c, "active", 0, "1");
+    CLASS_ATTR_STYLE_LABEL(c, "active", 0, "onoff", "Toggle smoothing");
+
+    CLASS_ATTR_DOUBLE(c, "time", 0, t_smoov_tilde, s_time);
+    CLASS_ATTR_ACCESSORS(c, "time", NULL, smoov_tilde_settime);
+    CLASS_ATTR_ORDER(c, "time", 0, "2");
+    CLASS_ATTR_LABEL(c, "time", 0, "Time constant in Milliseconds");
+
+    CLASS_ATTR_DOUBLE(c, "freq", 0, t_smoov_tilde, s_freq);
+    CLASS_ATTR_ACCESSORS(c, "freq", NULL, smoov_tilde_setfreq);
+    CLASS_ATTR_ORDER(c, "freq", 0, "3");
+    CLASS_ATTR_LABEL(c, "freq", 0, "Cutoff frequency in Hz");
+
+    class_dspinit(c);
+	class_register(CLASS_BOX, c);
+	smoov_tilde_class = c;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+static void smoov_tilde_coef(t_smoov_tilde *x)
+{
+    // one-pole coefficient reaching 63% of a step after s_time ms, 1 when the time constant is 0
+    x->s_coef = (x->s_time > 0) ? 1.-exp(-x->s_step/x->s_time) : 1.;
+}
+
+void *smoov_tilde_new(t_symbol *s, long argc, t_atom *argv)
+{
+	t_smoov_tilde *x = (t_smoov_tilde *)object_alloc(smoov_tilde_class); // create a new instance of this object
+    t_atom av;
+
+    x->s_active = 1;                        // set active by default
+    x->s_step = 1000./44100.;               // updated by the dsp64 method
+    x->s_chans = 1;
+    x->s_cap = 0;
+    x->s_state = NULL;
+    atom_setfloat(&av,10.);                 // 10 ms by default
+    smoov_tilde_settime(x,NULL,1,&av);
+
+    if (argc>0) {
+        switch (atom_gettype(argv)) {
+            case A_LONG:
+            case A_FLOAT:
+                smoov_tilde_settime(x,NULL,1,argv);                    // set the initial time constant
+                break;
+            case A_SYM:
+                if ((atom_getsym(argv)->s_name)[0]=='@') break;       // test for attributes
+            default:
+                error("smoov~: first argument must be a time in milliseconds.");   // prompt an error message in the max window
+                break;
+        }
+    }
+
+    attr_args_process(x, argc, argv);       // process arguments
+
+    dsp_setup((t_pxobject *)x, 1);          // one multichannel signal inlet
+    x->s_ob.z_misc |= Z_NO_INPLACE;         // channels are read and written side by side
+    outlet_new(x, "multichannelsignal");
+
+	return(x);                              // return a reference to the object instance
+}
+
+void smoov_tilde_free(t_smoov_tilde *x)
+{
+    z_dsp_free((t_pxobject *)x);
+    free(x->s_state);
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+void smoov_tilde_assist(t_smoov_tilde *x, void *b, long m, long a, char *s)
+{
+	if (m == ASSIST_OUTLET)
+		sprintf(s,"(multichannel signal) Smoothed signal");
+	else
+        sprintf(s,"(multichannel signal) Signal to smooth");
+}
+
+t_max_err smoov_tilde_settime(t_smoov_tilde *x, void *attr, long argc, t_atom *argv)
+{
+    if (argc && argv) {
+        double t = atom_getfloat(argv);
+        x->s_time = (t<0.) ? 0. : t;
+        x->s_freq = (x->s_time > 0) ? 1000./(2*M_PI*x->s_time) : 0.;    // 0 Hz stands for no smoothing
+        smoov_tilde_coef(x);
+    }
+    return MAX_ERR_NONE;
+}
+
+t_max_err smoov_tilde_setfreq(t_smoov_tilde *x, void *attr, long argc, t_atom *argv)
+{
+    if (argc && argv) {
+        double f = atom_getfloat(argv);
+        x->s_freq = (f<0.) ? 0. : f;
+        x->s_time = (x->s_freq > 0) ? 1000./(2*M_PI*x->s_freq) : 0.;
+        smoov_tilde_coef(x);
+    }
+    return MAX_ERR_NONE;
+}
+
+void smoov_tilde_clear(t_smoov_tilde *x)
+{
+    long i;
+    for (i=0;i<x->s_cap;i++)
+        x->s_state[i] = 0.;
+}
+
+//---------------------------------------------------------------------------------------------------------------------------------------------------------
+
+long smoov_tilde_inputchanged(t_smoov_tilde *x, long index, long count)
+{
+    if (count != x->s_chans) {
+        x->s_chans = count;
+        return true;
+    }
+    return false;
+}
+
+long smoov_tilde_multichanneloutputs(t_smoov_tilde *x, long index)
+{
+    return x->s_chans;
+}
+
+void smoov_tilde_dsp64(t_smoov_tilde *x, t_object *dsp64, short *count, double samplerate, long maxvectorsize, long flags)
+{
+    if (x->s_chans > x->s_cap) {
+        double *tmp = realloc(x->s_state, x->s_chans*sizeof(double));
+        if (!tmp) {
+            object_error((t_object *)x, "smoov~: out of memory");
+            return;
+        }
+        memset(tmp+x->s_cap, 0, (x->s_chans-x->s_cap)*sizeof(double));
+        x->s_state = tmp;
+        x->s_cap = x->s_chans;
+    }
+    x->s_step = 1000./samplerate;
+    smoov_tilde_coef(x);
+    object_method(dsp64, gensym("dsp_add64"), x, smoov_tilde_perform64, 0, NULL);
+}
+
+static void smoov_tilde_channel(const double *in, double *out, double *state, double coef, long n)
+{
+    // one channel over the block, y += coef*(x-y) written y = (1-coef)*y + coef*x: the input is scaled by a contiguous loop
+    // the compiler vectorizes, then the recursion over the samples, sequential by nature, is one multiply-add per sample
+    long j;
+    double y = *state, b = 1.-coef;
+    for (j=0;j<n;j++)
+        out[j] = coef*in[j];
+    for (j=0;j<n;j++) {
+        y = b*y + out[j];
+        out[j] = y;
+    }
+    *state = y;
+}
+
+void smoov_tilde_perform64(t_smoov_tilde *x, t_object *dsp64, double **ins, long numins, double **outs, long numouts, long sampleframes, long flags, void *userparam)
+{
+    long i;
+    long n = (numins < numouts) ? numins : numouts;
+    double coef = x->s_active ? x->s_coef : 1.;
+
+    for (i=0;i<n;i++)                       // one channel at a time, its samples are contiguous
+        smoov_tilde_channel(ins[i], outs[i], x->s_state+i, coef, sampleframes);
+    for (;i<numouts;i++)
+        memset(outs[i], 0, sampleframes*sizeof(double));
+}